@@ -0,0 +1,533 @@
+#include "MaterialVaultCatalog.h"
+#include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Materials/MaterialInstanceConstant.h"
+
+FMaterialVaultCatalog::FMaterialVaultCatalog(const FString& InRootFolder)
+	: RootFolder(InRootFolder)
+{
+	RootFolderNode = MakeShared<FMaterialVaultFolderNode>(TEXT("Root"), RootFolder);
+	ResetFolderStructure();
+}
+
+void FMaterialVaultCatalog::ResetFolderStructure()
+{
+	// Clear existing structure
+	RootFolderNode->Materials.Empty();
+	for (TArray<TSharedPtr<FMaterialVaultMaterialItem>>& SortedMaterials : RootFolderNode->SortedMaterials)
+	{
+		SortedMaterials.Empty();
+	}
+	RootFolderNode->Children.Empty();
+	FolderMap.Empty();
+	FolderMap.Add(RootFolder, RootFolderNode);
+	
+	// Create main category folders
+	TSharedPtr<FMaterialVaultFolderNode> ContentFolder = CreateFolderNode(TEXT("/Game"));
+	ContentFolder->FolderName = TEXT("Content");
+	TSharedPtr<FMaterialVaultFolderNode> EngineFolder = CreateFolderNode(TEXT("/Engine"));
+	EngineFolder->FolderName = TEXT("Engine");
+	TSharedPtr<FMaterialVaultFolderNode> PluginFolder = CreateFolderNode(TEXT("/Plugins"));
+	PluginFolder->FolderName = TEXT("Plugins");
+	
+	ContentFolder->Parent = RootFolderNode;
+	EngineFolder->Parent = RootFolderNode;
+	PluginFolder->Parent = RootFolderNode;
+	RootFolderNode->Children.Add(ContentFolder);
+	RootFolderNode->Children.Add(EngineFolder);
+	RootFolderNode->Children.Add(PluginFolder);
+	
+	FolderMap.Add(TEXT("/Game"), ContentFolder);
+	FolderMap.Add(TEXT("/Engine"), EngineFolder);
+	FolderMap.Add(TEXT("/Plugins"), PluginFolder);
+}
+
+void FMaterialVaultCatalog::AddMaterialToFolder(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem, bool bKeepSorted)
+{
+	if (!MaterialItem.IsValid())
+	{
+		return;
+	}
+	
+	// Create folder nodes for this path
+	TSharedPtr<FMaterialVaultFolderNode> FolderNode = GetOrCreateFolderNode(MaterialItem->OrganizedPath);
+	if (FolderNode.IsValid())
+	{
+		FolderNode->Materials.Add(MaterialItem);
+		if (bKeepSorted)
+		{
+			InsertSorted(*FolderNode, MaterialItem);
+		}
+	}
+}
+
+void FMaterialVaultCatalog::RemoveMaterialFromFolder(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem, const FString& FolderPath)
+{
+	TSharedPtr<FMaterialVaultFolderNode> FolderNode = FindFolder(FolderPath);
+	if (FolderNode.IsValid())
+	{
+		FolderNode->Materials.RemoveSingleSwap(MaterialItem);
+		RemoveSorted(*FolderNode, MaterialItem);
+		PruneEmptyFolders(FolderNode);
+	}
+}
+
+TSharedPtr<FMaterialVaultFolderNode> FMaterialVaultCatalog::FindFolder(const FString& FolderPath) const
+{
+	return FolderMap.FindRef(FolderPath);
+}
+
+void FMaterialVaultCatalog::SortAllFolders()
+{
+	for (const auto& FolderPair : FolderMap)
+	{
+		FMaterialVaultFolderNode& FolderNode = *FolderPair.Value;
+		for (int32 ModeIndex = 0; ModeIndex < (int32)EMaterialVaultSortMode::Count; ++ModeIndex)
+		{
+			EMaterialVaultSortMode SortMode = (EMaterialVaultSortMode)ModeIndex;
+			TArray<TSharedPtr<FMaterialVaultMaterialItem>>& SortedMaterials = FolderNode.SortedMaterials[ModeIndex];
+			SortedMaterials = FolderNode.Materials;
+			Algo::Sort(SortedMaterials, [SortMode](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
+			{
+				return CompareMaterials(*A, *B, SortMode);
+			});
+		}
+	}
+}
+
+FMaterialVaultSortKeys FMaterialVaultCatalog::MakeSortKeys(const FMaterialVaultMaterialItem& MaterialItem)
+{
+	FMaterialVaultSortKeys SortKeys;
+	SortKeys.Name = MaterialItem.DisplayName.ToLower();
+	SortKeys.Modified = MaterialItem.Metadata.LastModified;
+	SortKeys.Size = MaterialItem.ResourceSize;
+	
+	// Ranked in the same order their class paths sort in
+	const FTopLevelAssetPath& ClassPath = MaterialItem.AssetData.AssetClassPath;
+	if (ClassPath == UMaterial::StaticClass()->GetClassPathName())
+	{
+		SortKeys.Type = 0;
+	}
+	else if (ClassPath == UMaterialInstance::StaticClass()->GetClassPathName())
+	{
+		SortKeys.Type = 1;
+	}
+	else if (ClassPath == UMaterialInstanceConstant::StaticClass()->GetClassPathName())
+	{
+		SortKeys.Type = 2;
+	}
+	else
+	{
+		SortKeys.Type = 3;
+	}
+	
+	return SortKeys;
+}
+
+bool FMaterialVaultCatalog::CompareMaterials(const FMaterialVaultMaterialItem& A, const FMaterialVaultMaterialItem& B, EMaterialVaultSortMode SortMode)
+{
+	switch (SortMode)
+	{
+		case EMaterialVaultSortMode::DateModified:
+			if (A.SortKeys.Modified != B.SortKeys.Modified)
+			{
+				return A.SortKeys.Modified > B.SortKeys.Modified;
+			}
+			break;
+		case EMaterialVaultSortMode::Size:
+			// Heaviest first, so the materials that strain memory budgets come to the top
+			if (A.SortKeys.Size != B.SortKeys.Size)
+			{
+				return A.SortKeys.Size > B.SortKeys.Size;
+			}
+			break;
+		case EMaterialVaultSortMode::Type:
+			if (A.SortKeys.Type != B.SortKeys.Type)
+			{
+				return A.SortKeys.Type < B.SortKeys.Type;
+			}
+			break;
+		default:
+			break;
+	}
+	
+	// Name order, which also breaks ties for the other modes so every order is total
+	int32 NameOrder = A.SortKeys.Name.Compare(B.SortKeys.Name, ESearchCase::CaseSensitive);
+	if (NameOrder != 0)
+	{
+		return NameOrder < 0;
+	}
+	return A.AssetData.PackageName.Compare(B.AssetData.PackageName) < 0;
+}
+
+void FMaterialVaultCatalog::InsertSorted(FMaterialVaultFolderNode& FolderNode, const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	for (int32 ModeIndex = 0; ModeIndex < (int32)EMaterialVaultSortMode::Count; ++ModeIndex)
+	{
+		EMaterialVaultSortMode SortMode = (EMaterialVaultSortMode)ModeIndex;
+		TArray<TSharedPtr<FMaterialVaultMaterialItem>>& SortedMaterials = FolderNode.SortedMaterials[ModeIndex];
+		int32 InsertIndex = Algo::UpperBound(SortedMaterials, MaterialItem, [SortMode](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
+		{
+			return CompareMaterials(*A, *B, SortMode);
+		});
+		SortedMaterials.Insert(MaterialItem, InsertIndex);
+	}
+}
+
+void FMaterialVaultCatalog::RemoveSorted(FMaterialVaultFolderNode& FolderNode, const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	for (int32 ModeIndex = 0; ModeIndex < (int32)EMaterialVaultSortMode::Count; ++ModeIndex)
+	{
+		EMaterialVaultSortMode SortMode = (EMaterialVaultSortMode)ModeIndex;
+		TArray<TSharedPtr<FMaterialVaultMaterialItem>>& SortedMaterials = FolderNode.SortedMaterials[ModeIndex];
+		int32 RemoveIndex = Algo::LowerBound(SortedMaterials, MaterialItem, [SortMode](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
+		{
+			return CompareMaterials(*A, *B, SortMode);
+		});
+		
+		// Items whose keys changed after filing aren't where a search would find them, fall back to a scan
+		if (!SortedMaterials.IsValidIndex(RemoveIndex) || SortedMaterials[RemoveIndex] != MaterialItem)
+		{
+			RemoveIndex = SortedMaterials.Find(MaterialItem);
+		}
+		if (RemoveIndex != INDEX_NONE)
+		{
+			SortedMaterials.RemoveAt(RemoveIndex, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void FMaterialVaultCatalog::UpdateSortKeys(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	FMaterialVaultSortKeys NewSortKeys = MakeSortKeys(*MaterialItem);
+	if (NewSortKeys == MaterialItem->SortKeys)
+	{
+		return;
+	}
+	
+	// Re-file the item in its folder's sorted orders under the new keys
+	TSharedPtr<FMaterialVaultFolderNode> FolderNode = FindFolder(MaterialItem->OrganizedPath);
+	bool bFiled = FolderNode.IsValid() && FolderNode->Materials.Contains(MaterialItem);
+	if (bFiled)
+	{
+		RemoveSorted(*FolderNode, MaterialItem);
+	}
+	MaterialItem->SortKeys = MoveTemp(NewSortKeys);
+	if (bFiled)
+	{
+		InsertSorted(*FolderNode, MaterialItem);
+	}
+}
+
+void FMaterialVaultCatalog::RefreshSortKeys(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	if (MaterialItem.IsValid())
+	{
+		UpdateSortKeys(MaterialItem);
+	}
+}
+
+void FMaterialVaultCatalog::IndexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	IndexMaterialTags(MaterialItem);
+	SearchIndex.IndexMaterial(MaterialItem);
+	UpdateSortKeys(MaterialItem);
+}
+
+void FMaterialVaultCatalog::UnindexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	UnindexMaterialTags(MaterialItem);
+	UnindexMaterialTextures(MaterialItem);
+	SearchIndex.RemoveMaterial(MaterialItem);
+}
+
+void FMaterialVaultCatalog::IndexMaterialTags(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	if (!MaterialItem.IsValid())
+	{
+		return;
+	}
+	
+	TArray<FString> NewTags;
+	for (const FString& Tag : MaterialItem->Metadata.Tags)
+	{
+		if (!Tag.IsEmpty())
+		{
+			NewTags.AddUnique(Tag);
+		}
+	}
+	
+	// Only touch the tags that changed since the item was last indexed
+	TArray<FString>& OldTags = IndexedTags.FindOrAdd(MaterialItem);
+	for (const FString& Tag : OldTags)
+	{
+		if (!NewTags.Contains(Tag))
+		{
+			TSet<TSharedPtr<FMaterialVaultMaterialItem>>* TaggedMaterials = TagIndex.Find(Tag);
+			if (TaggedMaterials)
+			{
+				TaggedMaterials->Remove(MaterialItem);
+				if (TaggedMaterials->Num() == 0)
+				{
+					TagIndex.Remove(Tag);
+				}
+			}
+		}
+	}
+	for (const FString& Tag : NewTags)
+	{
+		if (!OldTags.Contains(Tag))
+		{
+			TagIndex.FindOrAdd(Tag).Add(MaterialItem);
+		}
+	}
+	
+	if (NewTags.Num() > 0)
+	{
+		OldTags = MoveTemp(NewTags);
+	}
+	else
+	{
+		IndexedTags.Remove(MaterialItem);
+	}
+}
+
+void FMaterialVaultCatalog::UnindexMaterialTags(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	TArray<FString> OldTags;
+	if (!IndexedTags.RemoveAndCopyValue(MaterialItem, OldTags))
+	{
+		return;
+	}
+	
+	for (const FString& Tag : OldTags)
+	{
+		TSet<TSharedPtr<FMaterialVaultMaterialItem>>* TaggedMaterials = TagIndex.Find(Tag);
+		if (TaggedMaterials)
+		{
+			TaggedMaterials->Remove(MaterialItem);
+			if (TaggedMaterials->Num() == 0)
+			{
+				TagIndex.Remove(Tag);
+			}
+		}
+	}
+}
+
+const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* FMaterialVaultCatalog::FindMaterialsWithTag(const FString& Tag) const
+{
+	return TagIndex.Find(Tag);
+}
+
+int32 FMaterialVaultCatalog::GetTagMaterialCount(const FString& Tag) const
+{
+	const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* TaggedMaterials = TagIndex.Find(Tag);
+	return TaggedMaterials ? TaggedMaterials->Num() : 0;
+}
+
+void FMaterialVaultCatalog::IndexMaterialTextures(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	if (!MaterialItem.IsValid())
+	{
+		return;
+	}
+	
+	TArray<FSoftObjectPath> NewTextures;
+	for (const TSoftObjectPtr<UTexture2D>& Texture : MaterialItem->TextureDependencies)
+	{
+		if (!Texture.IsNull())
+		{
+			NewTextures.AddUnique(Texture.ToSoftObjectPath());
+		}
+	}
+	
+	// Only touch the textures that changed since the item was last indexed
+	TArray<FSoftObjectPath>& OldTextures = IndexedTextures.FindOrAdd(MaterialItem);
+	for (const FSoftObjectPath& TexturePath : OldTextures)
+	{
+		if (!NewTextures.Contains(TexturePath))
+		{
+			TSet<TSharedPtr<FMaterialVaultMaterialItem>>* Users = TextureUsers.Find(TexturePath);
+			if (Users)
+			{
+				Users->Remove(MaterialItem);
+				if (Users->Num() == 0)
+				{
+					TextureUsers.Remove(TexturePath);
+				}
+			}
+		}
+	}
+	for (const FSoftObjectPath& TexturePath : NewTextures)
+	{
+		if (!OldTextures.Contains(TexturePath))
+		{
+			TextureUsers.FindOrAdd(TexturePath).Add(MaterialItem);
+		}
+	}
+	
+	if (NewTextures.Num() > 0)
+	{
+		OldTextures = MoveTemp(NewTextures);
+	}
+	else
+	{
+		IndexedTextures.Remove(MaterialItem);
+	}
+}
+
+void FMaterialVaultCatalog::UnindexMaterialTextures(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	TArray<FSoftObjectPath> OldTextures;
+	if (!IndexedTextures.RemoveAndCopyValue(MaterialItem, OldTextures))
+	{
+		return;
+	}
+	
+	for (const FSoftObjectPath& TexturePath : OldTextures)
+	{
+		TSet<TSharedPtr<FMaterialVaultMaterialItem>>* Users = TextureUsers.Find(TexturePath);
+		if (Users)
+		{
+			Users->Remove(MaterialItem);
+			if (Users->Num() == 0)
+			{
+				TextureUsers.Remove(TexturePath);
+			}
+		}
+	}
+}
+
+const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* FMaterialVaultCatalog::FindMaterialsUsingTexture(const FSoftObjectPath& TexturePath) const
+{
+	return TextureUsers.Find(TexturePath);
+}
+
+int32 FMaterialVaultCatalog::GetTextureUserCount(const FSoftObjectPath& TexturePath) const
+{
+	const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* Users = TextureUsers.Find(TexturePath);
+	return Users ? Users->Num() : 0;
+}
+
+void FMaterialVaultCatalog::PruneEmptyFolders(TSharedPtr<FMaterialVaultFolderNode> FolderNode)
+{
+	// Walk up removing folders left empty, keeping the root and the top-level Content/Engine/Plugins nodes
+	while (FolderNode.IsValid() && FolderNode != RootFolderNode && FolderNode->Parent != RootFolderNode &&
+		FolderNode->Materials.Num() == 0 && FolderNode->Children.Num() == 0)
+	{
+		TSharedPtr<FMaterialVaultFolderNode> ParentNode = FolderNode->Parent;
+		FolderMap.Remove(FolderNode->FolderPath);
+		if (ParentNode.IsValid())
+		{
+			ParentNode->Children.Remove(FolderNode);
+		}
+		FolderNode->Parent.Reset();
+		FolderNode = ParentNode;
+	}
+}
+
+TSharedPtr<FMaterialVaultFolderNode> FMaterialVaultCatalog::CreateFolderNode(const FString& FolderPath) const
+{
+	if (FolderPath.IsEmpty())
+	{
+		return nullptr;
+	}
+	
+	FString FolderName = FPaths::GetCleanFilename(FolderPath);
+	if (FolderName.IsEmpty())
+	{
+		FolderName = TEXT("Root");
+	}
+	
+	return MakeShared<FMaterialVaultFolderNode>(FolderName, FolderPath);
+}
+
+TSharedPtr<FMaterialVaultFolderNode> FMaterialVaultCatalog::GetOrCreateFolderNode(const FString& FolderPath)
+{
+	// Check if folder already exists
+	if (TSharedPtr<FMaterialVaultFolderNode>* ExistingFolder = FolderMap.Find(FolderPath))
+	{
+		return *ExistingFolder;
+	}
+	
+	// Create new folder
+	TSharedPtr<FMaterialVaultFolderNode> NewFolder = CreateFolderNode(FolderPath);
+	if (!NewFolder.IsValid())
+	{
+		return nullptr;
+	}
+	
+	// Add to map
+	FolderMap.Add(FolderPath, NewFolder);
+	
+	// Find parent folder
+	FString ParentPath = FPaths::GetPath(FolderPath);
+	if (!ParentPath.IsEmpty() && ParentPath != FolderPath)
+	{
+		TSharedPtr<FMaterialVaultFolderNode> ParentFolder = GetOrCreateFolderNode(ParentPath);
+		if (ParentFolder.IsValid())
+		{
+			NewFolder->Parent = ParentFolder;
+			ParentFolder->Children.Add(NewFolder);
+		}
+	}
+	else
+	{
+		// This is a root level folder
+		NewFolder->Parent = RootFolderNode;
+		RootFolderNode->Children.Add(NewFolder);
+	}
+	
+	return NewFolder;
+}
+
+FString FMaterialVaultCatalog::OrganizePackagePath(const FString& PackagePath)
+{
+	if (PackagePath.StartsWith(TEXT("/Game")))
+	{
+		// Game content goes to Content folder
+		return PackagePath;
+	}
+	else if (PackagePath.StartsWith(TEXT("/Engine")))
+	{
+		// Engine content stays in Engine folder
+		return PackagePath;
+	}
+	else
+	{
+		// Check for plugin patterns - plugins typically start with plugin name
+		TArray<FString> PathComponents;
+		PackagePath.ParseIntoArray(PathComponents, TEXT("/"), true);
+		
+		if (PathComponents.Num() > 0)
+		{
+			FString FirstComponent = PathComponents[0];
+			
+			// Check if this looks like a plugin (not Engine, not Game, not Script)
+			if (!FirstComponent.Equals(TEXT("Engine"), ESearchCase::IgnoreCase) &&
+				!FirstComponent.Equals(TEXT("Game"), ESearchCase::IgnoreCase) &&
+				!FirstComponent.Equals(TEXT("Script"), ESearchCase::IgnoreCase) &&
+				!FirstComponent.Equals(TEXT("Temp"), ESearchCase::IgnoreCase) &&
+				!FirstComponent.Equals(TEXT("Memory"), ESearchCase::IgnoreCase))
+			{
+				// This is likely a plugin
+				return FString::Printf(TEXT("/Plugins%s"), *PackagePath);
+			}
+		}
+		
+		// Check if it starts with known engine patterns
+		if (PackagePath.StartsWith(TEXT("/Script")) ||
+			PackagePath.StartsWith(TEXT("/Temp")) ||
+			PackagePath.StartsWith(TEXT("/Memory")) ||
+			PackagePath.Contains(TEXT("Engine")))
+		{
+			return FString::Printf(TEXT("/Engine%s"), *PackagePath);
+		}
+		
+		// Unknown content, put in Content by default
+		return FString::Printf(TEXT("/Game%s"), *PackagePath);
+	}
+}
@@ -1,4 +1,7 @@
 #include "MaterialVaultManager.h"
+#include "MaterialVaultCatalog.h"
+#include "MaterialVaultSnapshot.h"
+#include "MaterialVaultMetadataStore.h"
 #include "MaterialVaultThumbnailManager.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/AssetData.h"
@@ -10,9 +13,6 @@
 #include "Misc/DateTime.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
-#include "Dom/JsonObject.h"
-#include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonWriter.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "EditorActorFolders.h"
@@ -20,9 +20,19 @@
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "ScopedTransaction.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "PixelFormat.h"
 
 #define LOCTEXT_NAMESPACE "MaterialVaultManager"
 
+// Seconds without catalog changes before the snapshot is written in the background
+static const double MaterialVaultSnapshotIdleDelay = 30.0;
+
+// Cap on packages visited when estimating a material's footprint or gathering its textures, bounds the walk for heavily shared graphs
+static const int32 MaterialVaultMaxSizeDependencies = 512;
+
 UMaterialVaultManager::UMaterialVaultManager()
 	: AssetRegistryModule(nullptr)
 	, bIsInitialized(false)
@@ -42,20 +52,30 @@ void UMaterialVaultManager::Initialize(FSubsystemCollectionBase& Collection)
 		AssetRegistry.OnAssetRemoved().AddUObject(this, &UMaterialVaultManager::OnAssetRemoved);
 		AssetRegistry.OnAssetRenamed().AddUObject(this, &UMaterialVaultManager::OnAssetRenamed);
 		AssetRegistry.OnAssetUpdated().AddUObject(this, &UMaterialVaultManager::OnAssetUpdated);
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &UMaterialVaultManager::OnFilesLoaded);
 	}
 	
+	// Registry events are queued and applied once per tick as a single delta
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMaterialVaultManager::OnTick));
+	
 	// Initialize thumbnail manager
 	ThumbnailManager = MakeShared<FMaterialVaultThumbnailManager>();
 	ThumbnailManager->Initialize();
 	
-	// Initialize root folder
-	RootFolderNode = MakeShared<FMaterialVaultFolderNode>(TEXT("Root"), Settings.RootFolder);
-	FolderMap.Add(Settings.RootFolder, RootFolderNode);
+	// Load the metadata store before any catalog build reads from it
+	MetadataStore = MakeShared<FMaterialVaultMetadataStore>();
+	MetadataStore->Initialize();
 	
-	// Load initial data
-	RefreshMaterialDatabase();
+	// Start with an empty catalog until the first build is published
+	Catalog = MakeShared<FMaterialVaultCatalog>(Settings.RootFolder);
 	
 	bIsInitialized = true;
+	
+	// Load initial data, from the previous session's snapshot when there is a valid one
+	if (!RestoreCatalogSnapshot())
+	{
+		RefreshMaterialDatabase();
+	}
 }
 
 void UMaterialVaultManager::Deinitialize()
@@ -67,19 +87,64 @@ void UMaterialVaultManager::Deinitialize()
 		AssetRegistry.OnAssetRemoved().RemoveAll(this);
 		AssetRegistry.OnAssetRenamed().RemoveAll(this);
 		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+		AssetRegistry.OnFilesLoaded().RemoveAll(this);
+	}
+	
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	PendingAddedAssets.Empty();
+	PendingRemovedAssets.Empty();
+	
+	// Only trust the catalog to say what was deleted when it is complete and current
+	bool bCanPruneThumbnails = Catalog.IsValid() && !ActiveCatalogBuild.IsValid() && !bCatalogNeedsValidation && !ActiveCatalogReconcile.IsValid()
+		&& AssetRegistryModule && !AssetRegistryModule->Get().IsLoadingAssets();
+	ActiveCatalogReconcile.Reset();
+	
+	// Any build still running is discarded when it completes
+	if (ActiveCatalogBuild.IsValid())
+	{
+		ActiveCatalogBuild.Reset();
+		FinishCatalogBuildNotification(false);
+	}
+	
+	if (bSnapshotDirty)
+	{
+		SaveCatalogSnapshot(false);
+	}
+	if (SnapshotWriteTask.IsValid())
+	{
+		SnapshotWriteTask.Wait();
 	}
 	
 	if (ThumbnailManager.IsValid())
 	{
+		FMaterialVaultThumbnailCacheStats Stats = ThumbnailManager->GetCacheStats();
+		UE_LOG(LogTemp, Log, TEXT("MaterialVault: Thumbnail cache had %lld hits, %lld misses, %lld joined requests and %lld evictions, %d thumbnails in %lld KB"),
+			Stats.Hits, Stats.Misses, Stats.JoinedRequests, Stats.Evictions, Stats.NumEntries, Stats.BytesUsed / 1024);
+		
+		// Texture thumbnails are cached too, so anything still in the registry is kept; the shutdown compaction drops the rest
+		if (bCanPruneThumbnails)
+		{
+			IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+			ThumbnailManager->PruneDiskCache([this, &AssetRegistry](FName ObjectPath)
+			{
+				FString ObjectPathString = ObjectPath.ToString();
+				return Catalog->MaterialMap.Contains(ObjectPathString) || AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(ObjectPathString)).IsValid();
+			});
+		}
+		
 		ThumbnailManager->Shutdown();
 		ThumbnailManager.Reset();
 	}
 	
+	if (MetadataStore.IsValid())
+	{
+		MetadataStore->Shutdown();
+		MetadataStore.Reset();
+	}
+	
 	// Clean up data
-	FolderMap.Empty();
-	MaterialMap.Empty();
-	MetadataCache.Empty();
-	RootFolderNode.Reset();
+	Catalog.Reset();
 	
 	bIsInitialized = false;
 	
@@ -93,95 +158,244 @@ void UMaterialVaultManager::RefreshMaterialDatabase()
 		return;
 	}
 	
-	// Clear existing data
-	MaterialMap.Empty();
-	if (RootFolderNode.IsValid())
-	{
-		RootFolderNode->Materials.Empty();
-		RootFolderNode->Children.Empty();
-	}
-	
 	// Get all material assets
-	TArray<FAssetData> MaterialAssets;
+	TSharedPtr<FMaterialVaultCatalogBuild> Build = MakeShared<FMaterialVaultCatalogBuild>();
+	GatherMaterialAssets(Build->MaterialAssets);
+	
+	// The registry snapshot supersedes any queued events; new ones are held until the build is published
+	PendingAddedAssets.Empty();
+	PendingRemovedAssets.Empty();
+	bCatalogNeedsValidation = false;
+	ActiveCatalogReconcile.Reset();
+	
+	// Textures may have been re-imported since their details were read
+	TextureInfoCache.Empty();
+	
+	Build->Catalog = MakeShared<FMaterialVaultCatalog>(Settings.RootFolder);
+	
+	StartCatalogBuild(Build);
+}
+
+void UMaterialVaultManager::GatherMaterialAssets(TArray<FAssetData>& OutMaterialAssets) const
+{
 	if (AssetRegistryModule)
 	{
 		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
 		
 		// Get materials and material instances
-		AssetRegistry.GetAssetsByClass(UMaterial::StaticClass()->GetClassPathName(), MaterialAssets);
+		AssetRegistry.GetAssetsByClass(UMaterial::StaticClass()->GetClassPathName(), OutMaterialAssets);
+		AssetRegistry.GetAssetsByClass(UMaterialInstance::StaticClass()->GetClassPathName(), OutMaterialAssets);
+		AssetRegistry.GetAssetsByClass(UMaterialInstanceConstant::StaticClass()->GetClassPathName(), OutMaterialAssets);
+	}
+}
+
+void UMaterialVaultManager::StartCatalogBuild(TSharedPtr<FMaterialVaultCatalogBuild> Build)
+{
+	// Starting a new build supersedes one already in flight, the current catalog stays in use meanwhile
+	Build->MetadataStore = MetadataStore;
+	Build->TextureClassPaths = GetTextureClassPaths();
+	ActiveCatalogBuild = Build;
+	MetadataSavedDuringBuild.Empty();
+	UpdateCatalogBuildNotification();
+	
+	TWeakObjectPtr<UMaterialVaultManager> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Build]()
+	{
+		BuildCatalog(*Build);
 		
-		TArray<FAssetData> MaterialInstanceAssets;
-		AssetRegistry.GetAssetsByClass(UMaterialInstance::StaticClass()->GetClassPathName(), MaterialInstanceAssets);
-		MaterialAssets.Append(MaterialInstanceAssets);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Build]()
+		{
+			if (UMaterialVaultManager* Manager = WeakThis.Get())
+			{
+				Manager->PublishCatalog(Build);
+			}
+		});
+	});
+}
+
+void UMaterialVaultManager::BuildFolderStructure()
+{
+	if (!Catalog.IsValid())
+	{
+		return;
+	}
+	
+	// Rebuild structure from materials
+	Catalog->ResetFolderStructure();
+	for (const auto& MaterialPair : Catalog->MaterialMap)
+	{
+		Catalog->AddMaterialToFolder(MaterialPair.Value, false);
+	}
+	Catalog->SortAllFolders();
+}
+
+void UMaterialVaultManager::BuildCatalog(FMaterialVaultCatalogBuild& Build)
+{
+	const TArray<FAssetData>& MaterialAssets = Build.MaterialAssets;
+	
+	// Create items and look up their metadata in parallel, each worker only touches its own slot
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> MaterialItems;
+	MaterialItems.SetNum(MaterialAssets.Num());
+	
+	ParallelFor(MaterialAssets.Num(), [&](int32 Index)
+	{
+		const FAssetData& AssetData = MaterialAssets[Index];
+		TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = MakeShared<FMaterialVaultMaterialItem>(AssetData);
+		MaterialItem->OrganizedPath = FMaterialVaultCatalog::OrganizePackagePath(AssetData.PackagePath.ToString());
 		
-		AssetRegistry.GetAssetsByClass(UMaterialInstanceConstant::StaticClass()->GetClassPathName(), MaterialInstanceAssets);
-		MaterialAssets.Append(MaterialInstanceAssets);
+		if (const FMaterialVaultPackageInfo* KnownPackage = Build.KnownPackages.Find(AssetData.PackageName))
+		{
+			MaterialItem->PackageSavedHash = KnownPackage->SavedHash;
+			MaterialItem->DiskSize = KnownPackage->DiskSize;
+			MaterialItem->ResourceSize = KnownPackage->ResourceSize;
+			MaterialItem->bDependenciesResolved = KnownPackage->bDependenciesResolved;
+			for (const FSoftObjectPath& TexturePath : KnownPackage->TextureDependencies)
+			{
+				MaterialItem->TextureDependencies.Emplace(TexturePath);
+			}
+		}
+		else
+		{
+			MaterialItem->PackageSavedHash = GetPackageSavedHash(AssetData.PackageName);
+			GetPackageSizes(AssetData.PackageName, MaterialItem->DiskSize, MaterialItem->ResourceSize);
+			
+			TArray<FSoftObjectPath> TexturePaths;
+			GatherTextureDependencies(AssetData.PackageName, Build.TextureClassPaths, TexturePaths);
+			for (const FSoftObjectPath& TexturePath : TexturePaths)
+			{
+				MaterialItem->TextureDependencies.Emplace(TexturePath);
+			}
+			MaterialItem->bDependenciesResolved = true;
+		}
+		
+		Build.MetadataStore->Find(AssetData.GetObjectPathString(), MaterialItem->Metadata);
+		MaterialItem->SortKeys = FMaterialVaultCatalog::MakeSortKeys(*MaterialItem);
+		
+		MaterialItems[Index] = MaterialItem;
+		Build.ProcessedCount.Increment();
+	});
+	
+	// Filing into the folder tree touches shared maps, so it stays serial
+	FMaterialVaultCatalog& NewCatalog = *Build.Catalog;
+	NewCatalog.MaterialMap.Reserve(MaterialItems.Num());
+	for (const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem : MaterialItems)
+	{
+		FString ObjectPath = MaterialItem->AssetData.GetObjectPathString();
+		if (NewCatalog.MaterialMap.Contains(ObjectPath))
+		{
+			continue;
+		}
+		
+		NewCatalog.MaterialMap.Add(ObjectPath, MaterialItem);
+		NewCatalog.AddMaterialToFolder(MaterialItem, false);
+		NewCatalog.IndexMaterial(MaterialItem);
+		NewCatalog.IndexMaterialTextures(MaterialItem);
+	}
+	
+	// One sort per folder and mode instead of an insertion per item
+	NewCatalog.SortAllFolders();
+}
+
+void UMaterialVaultManager::PublishCatalog(TSharedPtr<FMaterialVaultCatalogBuild> Build)
+{
+	// Drop results of a build that was superseded or outlived the subsystem
+	if (!bIsInitialized || !Build.IsValid() || Build != ActiveCatalogBuild)
+	{
+		return;
+	}
+	
+	// Metadata saved while the build was running wins over what the build read
+	for (const FString& ObjectPath : MetadataSavedDuringBuild)
+	{
+		TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = Build->Catalog->MaterialMap.FindRef(ObjectPath);
+		if (MaterialItem.IsValid())
+		{
+			MetadataStore->Find(ObjectPath, MaterialItem->Metadata);
+			Build->Catalog->IndexMaterial(MaterialItem);
+		}
 	}
+	MetadataSavedDuringBuild.Empty();
 	
-	// Process each material
-	for (const FAssetData& AssetData : MaterialAssets)
+	for (const auto& MaterialPair : Build->Catalog->MaterialMap)
 	{
-		ProcessMaterialAsset(AssetData);
+		const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem = MaterialPair.Value;
+		
+		// Carry over state the current catalog has already loaded
+		TSharedPtr<FMaterialVaultMaterialItem> PreviousItem = Catalog->MaterialMap.FindRef(MaterialPair.Key);
+		if (PreviousItem.IsValid())
+		{
+			// Dependencies resolved since the snapshot stay valid as long as the package has not been re-saved
+			if (!MaterialItem->bDependenciesResolved && PreviousItem->bDependenciesResolved && PreviousItem->PackageSavedHash == MaterialItem->PackageSavedHash)
+			{
+				MaterialItem->TextureDependencies = PreviousItem->TextureDependencies;
+				MaterialItem->bDependenciesResolved = true;
+				Build->Catalog->IndexMaterialTextures(MaterialItem);
+			}
+		}
 	}
 	
-	// Build folder structure
-	BuildFolderStructure();
+	Catalog = Build->Catalog;
+	ActiveCatalogBuild.Reset();
+	FinishCatalogBuildNotification(true);
+	
+	if (!Build->bRestoredFromSnapshot)
+	{
+		MarkSnapshotDirty();
+	}
 	
 	// Broadcast refresh complete
 	OnRefreshRequested.Broadcast();
+	
+	// Apply registry changes that arrived while the build was running, unless discovery is still going,
+	// in which case OnFilesLoaded reconciles and applies them in one batch
+	if (!AssetRegistryModule || !AssetRegistryModule->Get().IsLoadingAssets())
+	{
+		FlushPendingAssetEvents();
+	}
 }
 
-void UMaterialVaultManager::BuildFolderStructure()
+void UMaterialVaultManager::UpdateCatalogBuildNotification()
 {
-	if (!RootFolderNode.IsValid())
+	if (!ActiveCatalogBuild.IsValid())
 	{
 		return;
 	}
 	
-	// Clear existing structure
-	RootFolderNode->Children.Empty();
-	FolderMap.Empty();
-	FolderMap.Add(Settings.RootFolder, RootFolderNode);
+	FText ProgressText = FText::Format(LOCTEXT("BuildingCatalog", "Building material catalog ({0} / {1})"),
+		FText::AsNumber(ActiveCatalogBuild->ProcessedCount.GetValue()), FText::AsNumber(ActiveCatalogBuild->MaterialAssets.Num()));
 	
-	// Create main category folders
-	TSharedPtr<FMaterialVaultFolderNode> ContentFolder = CreateFolderNode(TEXT("/Game"));
-	ContentFolder->FolderName = TEXT("Content");
-	TSharedPtr<FMaterialVaultFolderNode> EngineFolder = CreateFolderNode(TEXT("/Engine"));
-	EngineFolder->FolderName = TEXT("Engine");
-	TSharedPtr<FMaterialVaultFolderNode> PluginFolder = CreateFolderNode(TEXT("/Plugins"));
-	PluginFolder->FolderName = TEXT("Plugins");
-	
-	if (RootFolderNode.IsValid())
+	TSharedPtr<SNotificationItem> Notification = CatalogBuildNotification.Pin();
+	if (Notification.IsValid())
 	{
-		ContentFolder->Parent = RootFolderNode;
-		EngineFolder->Parent = RootFolderNode;
-		PluginFolder->Parent = RootFolderNode;
-		RootFolderNode->Children.Add(ContentFolder);
-		RootFolderNode->Children.Add(EngineFolder);
-		RootFolderNode->Children.Add(PluginFolder);
+		Notification->SetText(ProgressText);
+		return;
 	}
 	
-	FolderMap.Add(TEXT("/Game"), ContentFolder);
-	FolderMap.Add(TEXT("/Engine"), EngineFolder);
-	FolderMap.Add(TEXT("/Plugins"), PluginFolder);
-	
-	// Build structure from materials
-	for (const auto& MaterialPair : MaterialMap)
+	FNotificationInfo Info(ProgressText);
+	Info.bFireAndForget = false;
+	Info.bUseThrobber = true;
+	Info.ExpireDuration = 2.0f;
+	Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Notification.IsValid())
 	{
-		const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem = MaterialPair.Value;
-		if (MaterialItem.IsValid())
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+		CatalogBuildNotification = Notification;
+	}
+}
+
+void UMaterialVaultManager::FinishCatalogBuildNotification(bool bSucceeded)
+{
+	TSharedPtr<SNotificationItem> Notification = CatalogBuildNotification.Pin();
+	if (Notification.IsValid())
+	{
+		if (bSucceeded && Catalog.IsValid())
 		{
-			FString PackagePath = MaterialItem->AssetData.PackagePath.ToString();
-			FString OrganizedPath = OrganizePackagePath(PackagePath);
-			
-			// Create folder nodes for this path
-			TSharedPtr<FMaterialVaultFolderNode> FolderNode = GetOrCreateFolderNode(OrganizedPath);
-			if (FolderNode.IsValid())
-			{
-				FolderNode->Materials.Add(MaterialItem);
-			}
+			Notification->SetText(FText::Format(LOCTEXT("CatalogBuilt", "Material catalog ready ({0} materials)"), FText::AsNumber(Catalog->MaterialMap.Num())));
 		}
+		Notification->SetCompletionState(bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_None);
+		Notification->ExpireAndFadeout();
 	}
+	CatalogBuildNotification.Reset();
 }
 
 void UMaterialVaultManager::LoadMaterialsFromFolder(const FString& FolderPath)
@@ -200,9 +414,14 @@ void UMaterialVaultManager::LoadMaterialsFromFolder(const FString& FolderPath)
 	}
 }
 
+TSharedPtr<FMaterialVaultFolderNode> UMaterialVaultManager::GetRootFolder() const
+{
+	return Catalog.IsValid() ? Catalog->RootFolderNode : nullptr;
+}
+
 TSharedPtr<FMaterialVaultFolderNode> UMaterialVaultManager::FindFolder(const FString& FolderPath) const
 {
-	return FolderMap.FindRef(FolderPath);
+	return Catalog.IsValid() ? Catalog->FindFolder(FolderPath) : nullptr;
 }
 
 TArray<TSharedPtr<FMaterialVaultFolderNode>> UMaterialVaultManager::GetChildFolders(const FString& FolderPath) const
@@ -220,52 +439,136 @@ TArray<TSharedPtr<FMaterialVaultMaterialItem>> UMaterialVaultManager::GetMateria
 	TSharedPtr<FMaterialVaultFolderNode> FolderNode = FindFolder(FolderPath);
 	if (FolderNode.IsValid())
 	{
-		TArray<TSharedPtr<FMaterialVaultMaterialItem>> SortedMaterials = FolderNode->Materials;
-		SortMaterials(SortedMaterials);
-		return SortedMaterials;
+		// Folders keep every sort order up to date, so this is just a copy
+		return FolderNode->SortedMaterials[(int32)Settings.SortMode];
 	}
 	return TArray<TSharedPtr<FMaterialVaultMaterialItem>>();
 }
 
 TSharedPtr<FMaterialVaultMaterialItem> UMaterialVaultManager::GetMaterialByPath(const FString& AssetPath) const
 {
-	return MaterialMap.FindRef(AssetPath);
+	return Catalog.IsValid() ? Catalog->MaterialMap.FindRef(AssetPath) : nullptr;
 }
 
 void UMaterialVaultManager::LoadMaterialThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem)
 {
 	if (MaterialItem.IsValid() && ThumbnailManager.IsValid())
 	{
-		ThumbnailManager->LoadThumbnailAsync(MaterialItem, (int32)Settings.ThumbnailSize);
+		ThumbnailManager->RequestThumbnail(MaterialItem, (int32)Settings.ThumbnailSize);
 	}
 }
 
-void UMaterialVaultManager::LoadMaterialDependencies(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem)
+int32 UMaterialVaultManager::RequestMaterialThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bOnScreen)
 {
-	if (!MaterialItem.IsValid())
+	if (!MaterialItem.IsValid() || !ThumbnailManager.IsValid())
 	{
-		return;
+		return INDEX_NONE;
+	}
+	return ThumbnailManager->RequestThumbnail(MaterialItem, ThumbnailSize, MoveTemp(OnThumbnailReady), bOnScreen);
+}
+
+int32 UMaterialVaultManager::RequestAssetThumbnail(const FAssetData& AssetData, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bOnScreen)
+{
+	if (!AssetData.IsValid() || !ThumbnailManager.IsValid())
+	{
+		return INDEX_NONE;
 	}
 	
-	// Load the material if not already loaded
-	UMaterialInterface* Material = MaterialItem->MaterialPtr.LoadSynchronous();
-	if (!Material)
+	// Vault materials already carry their hash, anything else such as a texture looks it up
+	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = GetMaterialByPath(AssetData.GetObjectPathString());
+	if (MaterialItem.IsValid())
+	{
+		return ThumbnailManager->RequestThumbnail(MaterialItem, ThumbnailSize, MoveTemp(OnThumbnailReady), bOnScreen);
+	}
+	return ThumbnailManager->RequestThumbnail(AssetData, GetPackageSavedHash(AssetData.PackageName), ThumbnailSize, MoveTemp(OnThumbnailReady), bOnScreen);
+}
+
+void UMaterialVaultManager::CancelMaterialThumbnail(int32 RequestId)
+{
+	if (ThumbnailManager.IsValid() && RequestId != INDEX_NONE)
+	{
+		ThumbnailManager->CancelThumbnailRequest(RequestId);
+	}
+}
+
+FMaterialVaultThumbnailCacheStats UMaterialVaultManager::GetThumbnailStats() const
+{
+	return ThumbnailManager.IsValid() ? ThumbnailManager->GetCacheStats() : FMaterialVaultThumbnailCacheStats();
+}
+
+void UMaterialVaultManager::RequestMaterialDependencies(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem)
+{
+	if (!MaterialItem.IsValid() || MaterialItem->bDependenciesResolved)
 	{
 		return;
 	}
 	
-	// Get texture dependencies
-	TArray<UTexture*> ReferencedTextures;
-	Material->GetUsedTextures(ReferencedTextures, EMaterialQualityLevel::Num, true, ERHIFeatureLevel::Num, true);
+	FString ObjectPath = MaterialItem->AssetData.GetObjectPathString();
+	if (PendingDependencyRequests.Contains(ObjectPath))
+	{
+		return;
+	}
+	PendingDependencyRequests.Add(ObjectPath);
 	
-	MaterialItem->TextureDependencies.Empty();
-	for (UTexture* Texture : ReferencedTextures)
+	// The package's saved hash and sizes are read with the textures, the size walk is as deep as the texture one
+	TWeakObjectPtr<UMaterialVaultManager> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, ObjectPath, PackageName = MaterialItem->AssetData.PackageName, TextureClasses = GetTextureClassPaths()]()
 	{
-		if (UTexture2D* Texture2D = Cast<UTexture2D>(Texture))
+		FMaterialVaultPackageInfo PackageInfo;
+		PackageInfo.SavedHash = GetPackageSavedHash(PackageName);
+		GetPackageSizes(PackageName, PackageInfo.DiskSize, PackageInfo.ResourceSize);
+		GatherTextureDependencies(PackageName, TextureClasses, PackageInfo.TextureDependencies);
+		PackageInfo.bDependenciesResolved = true;
+		
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, ObjectPath, PackageInfo = MoveTemp(PackageInfo)]()
 		{
-			MaterialItem->TextureDependencies.Add(Texture2D);
-		}
+			if (UMaterialVaultManager* Manager = WeakThis.Get())
+			{
+				Manager->OnMaterialDependenciesGathered(ObjectPath, PackageInfo);
+			}
+		});
+	});
+}
+
+void UMaterialVaultManager::OnMaterialDependenciesGathered(const FString& ObjectPath, const FMaterialVaultPackageInfo& PackageInfo)
+{
+	PendingDependencyRequests.Remove(ObjectPath);
+	bool bSuperseded = SupersededDependencyRequests.Remove(ObjectPath) > 0;
+	
+	// The catalog may have been rebuilt or the material removed while the walk ran
+	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = GetMaterialByPath(ObjectPath);
+	if (!MaterialItem.IsValid() || MaterialItem->bDependenciesResolved)
+	{
+		return;
 	}
+	
+	// Re-saved meanwhile, the result is stale and the request it superseded was folded into this one
+	if (bSuperseded)
+	{
+		RequestMaterialDependencies(MaterialItem);
+		return;
+	}
+	
+	// A thumbnail cached under the previous save is dropped so the next request extracts the new one
+	if (MaterialItem->PackageSavedHash != PackageInfo.SavedHash && ThumbnailManager.IsValid())
+	{
+		ThumbnailManager->ClearThumbnailForMaterial(ObjectPath);
+	}
+	MaterialItem->PackageSavedHash = PackageInfo.SavedHash;
+	MaterialItem->DiskSize = PackageInfo.DiskSize;
+	MaterialItem->ResourceSize = PackageInfo.ResourceSize;
+	Catalog->RefreshSortKeys(MaterialItem);
+	
+	MaterialItem->TextureDependencies.Reset(PackageInfo.TextureDependencies.Num());
+	for (const FSoftObjectPath& TexturePath : PackageInfo.TextureDependencies)
+	{
+		MaterialItem->TextureDependencies.Add(TSoftObjectPtr<UTexture2D>(TexturePath));
+	}
+	MaterialItem->bDependenciesResolved = true;
+	Catalog->IndexMaterialTextures(MaterialItem);
+	MarkSnapshotDirty();
+	
+	OnMaterialDependenciesResolved.Broadcast(MaterialItem);
 }
 
 void UMaterialVaultManager::ApplyMaterialToSelection(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem)
@@ -395,32 +698,15 @@ void UMaterialVaultManager::SaveMaterialMetadata(TSharedPtr<FMaterialVaultMateri
 		return;
 	}
 	
-	// Update cache
-	MetadataCache.Add(MaterialItem->AssetData.GetObjectPathString(), MaterialItem->Metadata);
-	
-	// Save to file
-	FString MetadataPath = GetMetadataFilePath(MaterialItem->AssetData);
-	
-	TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
-	JsonObject->SetStringField(TEXT("MaterialName"), MaterialItem->Metadata.MaterialName);
-	JsonObject->SetStringField(TEXT("Location"), MaterialItem->Metadata.Location);
-	JsonObject->SetStringField(TEXT("Author"), MaterialItem->Metadata.Author);
-	JsonObject->SetStringField(TEXT("LastModified"), MaterialItem->Metadata.LastModified.ToString());
-	JsonObject->SetStringField(TEXT("Notes"), MaterialItem->Metadata.Notes);
-	JsonObject->SetStringField(TEXT("Category"), MaterialItem->Metadata.Category);
-	
-	TArray<TSharedPtr<FJsonValue>> TagsArray;
-	for (const FString& Tag : MaterialItem->Metadata.Tags)
+	FString ObjectPath = MaterialItem->AssetData.GetObjectPathString();
+	if (ActiveCatalogBuild.IsValid())
 	{
-		TagsArray.Add(MakeShareable(new FJsonValueString(Tag)));
+		MetadataSavedDuringBuild.Add(ObjectPath);
 	}
-	JsonObject->SetArrayField(TEXT("Tags"), TagsArray);
 	
-	FString OutputString;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-	FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-	
-	FFileHelper::SaveStringToFile(OutputString, *MetadataPath);
+	// A single append to the metadata store
+	MetadataStore->Put(ObjectPath, MaterialItem->Metadata);
+	ReindexMaterial(MaterialItem);
 }
 
 void UMaterialVaultManager::LoadMaterialMetadata(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem)
@@ -430,47 +716,16 @@ void UMaterialVaultManager::LoadMaterialMetadata(TSharedPtr<FMaterialVaultMateri
 		return;
 	}
 	
-	// Check cache first
-	FString ObjectPath = MaterialItem->AssetData.GetObjectPathString();
-	if (MetadataCache.Contains(ObjectPath))
-	{
-		MaterialItem->Metadata = MetadataCache[ObjectPath];
-		return;
-	}
-	
-	// Load from file
-	FString MetadataPath = GetMetadataFilePath(MaterialItem->AssetData);
-	
-	FString FileContents;
-	if (FFileHelper::LoadFileToString(FileContents, *MetadataPath))
+	MetadataStore->Find(MaterialItem->AssetData.GetObjectPathString(), MaterialItem->Metadata);
+	ReindexMaterial(MaterialItem);
+}
+
+void UMaterialVaultManager::ReindexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	// Items from a catalog that has since been replaced are not indexed
+	if (Catalog.IsValid() && Catalog->MaterialMap.FindRef(MaterialItem->AssetData.GetObjectPathString()) == MaterialItem)
 	{
-		TSharedPtr<FJsonObject> JsonObject;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
-		
-		if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
-		{
-			MaterialItem->Metadata.MaterialName = JsonObject->GetStringField(TEXT("MaterialName"));
-			MaterialItem->Metadata.Location = JsonObject->GetStringField(TEXT("Location"));
-			MaterialItem->Metadata.Author = JsonObject->GetStringField(TEXT("Author"));
-			MaterialItem->Metadata.Notes = JsonObject->GetStringField(TEXT("Notes"));
-			MaterialItem->Metadata.Category = JsonObject->GetStringField(TEXT("Category"));
-			
-			FString DateString = JsonObject->GetStringField(TEXT("LastModified"));
-			FDateTime::Parse(DateString, MaterialItem->Metadata.LastModified);
-			
-			const TArray<TSharedPtr<FJsonValue>>* TagsArray;
-			if (JsonObject->TryGetArrayField(TEXT("Tags"), TagsArray))
-			{
-				MaterialItem->Metadata.Tags.Empty();
-				for (const auto& TagValue : *TagsArray)
-				{
-					MaterialItem->Metadata.Tags.Add(TagValue->AsString());
-				}
-			}
-			
-			// Cache the loaded metadata
-			MetadataCache.Add(ObjectPath, MaterialItem->Metadata);
-		}
+		Catalog->IndexMaterial(MaterialItem);
 	}
 }
 
@@ -489,88 +744,340 @@ TArray<TSharedPtr<FMaterialVaultMaterialItem>> UMaterialVaultManager::SearchMate
 		return Results;
 	}
 	
-	FString LowerSearchTerm = SearchTerm.ToLower();
-	
-	for (const auto& MaterialPair : MaterialMap)
+	if (!Catalog.IsValid())
 	{
-		const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem = MaterialPair.Value;
-		if (MaterialItem.IsValid())
-		{
-			FString MaterialName = MaterialItem->DisplayName.ToLower();
-			FString MaterialPath = MaterialItem->AssetData.PackagePath.ToString().ToLower();
-			
-			if (MaterialName.Contains(LowerSearchTerm) || MaterialPath.Contains(LowerSearchTerm))
-			{
-				Results.Add(MaterialItem);
-			}
-		}
+		return Results;
 	}
 	
+	Catalog->SearchIndex.Search(SearchTerm, Results);
+	
 	SortMaterials(Results);
 	return Results;
 }
 
+void UMaterialVaultManager::GetSearchTexts(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials, TArray<FString>& OutSearchTexts) const
+{
+	if (Catalog.IsValid())
+	{
+		Catalog->SearchIndex.GetSearchTexts(Materials, OutSearchTexts);
+		return;
+	}
+	
+	OutSearchTexts.Reset(Materials.Num());
+	for (const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem : Materials)
+	{
+		OutSearchTexts.Add(FMaterialVaultSearchIndex::BuildSearchText(*MaterialItem));
+	}
+}
+
 TArray<TSharedPtr<FMaterialVaultMaterialItem>> UMaterialVaultManager::FilterMaterialsByTag(const FString& Tag) const
 {
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> Results;
 	
-	for (const auto& MaterialPair : MaterialMap)
+	if (!Catalog.IsValid())
 	{
-		const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem = MaterialPair.Value;
-		if (MaterialItem.IsValid() && MaterialItem->Metadata.Tags.Contains(Tag))
-		{
-			Results.Add(MaterialItem);
-		}
+		return Results;
+	}
+	
+	if (const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* TaggedMaterials = Catalog->FindMaterialsWithTag(Tag))
+	{
+		Results = TaggedMaterials->Array();
+	}
+	
+	SortMaterials(Results);
+	return Results;
+}
+
+int32 UMaterialVaultManager::GetMaterialCountForTag(const FString& Tag) const
+{
+	return Catalog.IsValid() ? Catalog->GetTagMaterialCount(Tag) : 0;
+}
+
+TArray<FString> UMaterialVaultManager::GetAllTags() const
+{
+	TArray<FString> Tags;
+	if (Catalog.IsValid())
+	{
+		Catalog->TagIndex.GetKeys(Tags);
+	}
+	return Tags;
+}
+
+TArray<TSharedPtr<FMaterialVaultMaterialItem>> UMaterialVaultManager::GetMaterialsUsingTexture(const FSoftObjectPath& TexturePath) const
+{
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> Results;
+	
+	if (!Catalog.IsValid())
+	{
+		return Results;
+	}
+	
+	if (const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* Users = Catalog->FindMaterialsUsingTexture(TexturePath))
+	{
+		Results = Users->Array();
 	}
 	
 	SortMaterials(Results);
 	return Results;
 }
 
+int32 UMaterialVaultManager::GetTextureUserCount(const FSoftObjectPath& TexturePath) const
+{
+	return Catalog.IsValid() ? Catalog->GetTextureUserCount(TexturePath) : 0;
+}
+
+bool UMaterialVaultManager::GetTextureInfo(const FSoftObjectPath& TexturePath, FMaterialVaultTextureInfo& OutInfo)
+{
+	if (const FMaterialVaultTextureInfo* CachedInfo = TextureInfoCache.Find(TexturePath))
+	{
+		OutInfo = *CachedInfo;
+		return true;
+	}
+	
+	if (TexturePath.IsNull() || PendingTextureInfoLoads.Contains(TexturePath))
+	{
+		return false;
+	}
+	
+	// A missing texture is cached like a failed load, so the row doesn't query the registry on every paint
+	FAssetData TextureAsset = IAssetRegistry::GetChecked().GetAssetByObjectPath(TexturePath);
+	if (!TextureAsset.IsValid())
+	{
+		FMaterialVaultTextureInfo MissingInfo;
+		MissingInfo.bMissing = true;
+		OutInfo = MissingInfo;
+		TextureInfoCache.Add(TexturePath, MoveTemp(MissingInfo));
+		return true;
+	}
+	
+	TOptional<FAssetPackageData> PackageData = IAssetRegistry::GetChecked().GetAssetPackageDataCopy(TextureAsset.PackageName);
+	int64 DiskSize = PackageData.IsSet() ? FMath::Max<int64>(PackageData->DiskSize, 0) : 0;
+	
+	FMaterialVaultTextureInfo TextureInfo;
+	if (ReadTextureInfoFromTags(TextureAsset, TextureInfo))
+	{
+		TextureInfo.DiskSize = DiskSize;
+		OutInfo = TextureInfo;
+		TextureInfoCache.Add(TexturePath, MoveTemp(TextureInfo));
+		return true;
+	}
+	
+	// Tags are missing for packages saved before they were recorded, load once in the background and cache the result
+	PendingTextureInfoLoads.Add(TexturePath);
+	TWeakObjectPtr<UMaterialVaultManager> WeakThis(this);
+	LoadPackageAsync(TextureAsset.PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda(
+		[WeakThis, TexturePath, DiskSize](const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+		{
+			if (UMaterialVaultManager* Manager = WeakThis.Get())
+			{
+				Manager->OnTexturePackageLoaded(TexturePath, DiskSize);
+			}
+		}));
+	return false;
+}
+
+bool UMaterialVaultManager::ReadTextureInfoFromTags(const FAssetData& TextureAsset, FMaterialVaultTextureInfo& OutInfo)
+{
+	// UTexture2D records its size as "<width>x<height>"
+	FString Dimensions;
+	if (!TextureAsset.GetTagValue(TEXT("Dimensions"), Dimensions))
+	{
+		return false;
+	}
+	
+	FString WidthString;
+	FString HeightString;
+	if (!Dimensions.Split(TEXT("x"), &WidthString, &HeightString))
+	{
+		return false;
+	}
+	
+	OutInfo.Width = FCString::Atoi(*WidthString);
+	OutInfo.Height = FCString::Atoi(*HeightString);
+	TextureAsset.GetTagValue(TEXT("Format"), OutInfo.Format);
+	return true;
+}
+
+void UMaterialVaultManager::OnTexturePackageLoaded(const FSoftObjectPath& TexturePath, int64 DiskSize)
+{
+	PendingTextureInfoLoads.Remove(TexturePath);
+	
+	// A failed load is cached too, so the row shows what is known instead of retrying every frame
+	FMaterialVaultTextureInfo TextureInfo;
+	TextureInfo.DiskSize = DiskSize;
+	if (UTexture* Texture = Cast<UTexture>(TexturePath.ResolveObject()))
+	{
+		TextureInfo.Width = Texture->Source.GetSizeX();
+		TextureInfo.Height = Texture->Source.GetSizeY();
+		if (UTexture2D* Texture2D = Cast<UTexture2D>(Texture))
+		{
+			TextureInfo.Format = GPixelFormats[Texture2D->GetPixelFormat()].Name;
+		}
+	}
+	TextureInfoCache.Add(TexturePath, MoveTemp(TextureInfo));
+}
+
 void UMaterialVaultManager::OnAssetAdded(const FAssetData& AssetData)
 {
-	if (AssetData.AssetClassPath == UMaterial::StaticClass()->GetClassPathName() ||
-		AssetData.AssetClassPath == UMaterialInstance::StaticClass()->GetClassPathName() ||
-		AssetData.AssetClassPath == UMaterialInstanceConstant::StaticClass()->GetClassPathName())
+	// A texture cached as missing may have been restored or re-imported under the same path
+	TextureInfoCache.Remove(AssetData.GetSoftObjectPath());
+	
+	if (IsMaterialAsset(AssetData))
 	{
-		ProcessMaterialAsset(AssetData);
-		BuildFolderStructure();
+		FString ObjectPath = AssetData.GetObjectPathString();
+		PendingRemovedAssets.Remove(ObjectPath);
+		PendingAddedAssets.Add(ObjectPath, AssetData);
 	}
 }
 
 void UMaterialVaultManager::OnAssetRemoved(const FAssetData& AssetData)
 {
-	RemoveMaterialAsset(AssetData);
-	BuildFolderStructure();
+	if (IsMaterialAsset(AssetData))
+	{
+		FString ObjectPath = AssetData.GetObjectPathString();
+		PendingAddedAssets.Remove(ObjectPath);
+		PendingRemovedAssets.Add(ObjectPath);
+	}
 }
 
 void UMaterialVaultManager::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
 {
-	RemoveMaterialAsset(AssetData);
-	ProcessMaterialAsset(AssetData);
-	BuildFolderStructure();
+	TextureInfoCache.Remove(AssetData.GetSoftObjectPath());
+	TextureInfoCache.Remove(FSoftObjectPath(OldObjectPath));
+	
+	if (IsMaterialAsset(AssetData))
+	{
+		// A rename is a removal of the old path plus an addition of the new one
+		PendingAddedAssets.Remove(OldObjectPath);
+		PendingRemovedAssets.Add(OldObjectPath);
+		
+		FString ObjectPath = AssetData.GetObjectPathString();
+		PendingRemovedAssets.Remove(ObjectPath);
+		PendingAddedAssets.Add(ObjectPath, AssetData);
+	}
 }
 
 void UMaterialVaultManager::OnAssetUpdated(const FAssetData& AssetData)
 {
-	if (AssetData.AssetClassPath == UMaterial::StaticClass()->GetClassPathName() ||
-		AssetData.AssetClassPath == UMaterialInstance::StaticClass()->GetClassPathName() ||
-		AssetData.AssetClassPath == UMaterialInstanceConstant::StaticClass()->GetClassPathName())
+	if (IsMaterialAsset(AssetData))
+	{
+		FString ObjectPath = AssetData.GetObjectPathString();
+		PendingRemovedAssets.Remove(ObjectPath);
+		PendingAddedAssets.Add(ObjectPath, AssetData);
+	}
+}
+
+void UMaterialVaultManager::OnFilesLoaded()
+{
+	// Initial discovery finished, ingest everything that was queued during the scan in one batch
+	FlushPendingAssetEvents();
+}
+
+bool UMaterialVaultManager::OnTick(float DeltaTime)
+{
+	if (ActiveCatalogBuild.IsValid())
+	{
+		UpdateCatalogBuildNotification();
+		return true;
+	}
+	
+	// Keep queuing while the registry is still scanning so startup discovery is applied once from OnFilesLoaded
+	if (AssetRegistryModule && AssetRegistryModule->Get().IsLoadingAssets())
+	{
+		return true;
+	}
+	
+	FlushPendingAssetEvents();
+	
+	// Persist the catalog once it has been quiet for a while
+	if (bSnapshotDirty && FPlatformTime::Seconds() - LastCatalogChangeTime > MaterialVaultSnapshotIdleDelay)
+	{
+		SaveCatalogSnapshot(true);
+	}
+	
+	return true;
+}
+
+void UMaterialVaultManager::FlushPendingAssetEvents()
+{
+	if (!Catalog.IsValid())
+	{
+		return;
+	}
+	
+	// Hold events until the catalog being built replaces the current one, or the registry check of a restored one is back
+	if (ActiveCatalogBuild.IsValid() || ActiveCatalogReconcile.IsValid())
+	{
+		return;
+	}
+	
+	// A catalog restored from the snapshot is checked against the registry once discovery has finished
+	if (bCatalogNeedsValidation && AssetRegistryModule && !AssetRegistryModule->Get().IsLoadingAssets())
+	{
+		bCatalogNeedsValidation = false;
+		ReconcileCatalogWithRegistry();
+		return;
+	}
+	
+	if (PendingAddedAssets.Num() == 0 && PendingRemovedAssets.Num() == 0)
+	{
+		return;
+	}
+	
+	// Apply removals first so renamed assets leave their old folder before being filed again
+	for (const FString& ObjectPath : PendingRemovedAssets)
+	{
+		TSharedPtr<FMaterialVaultMaterialItem> RemovedItem = RemoveMaterialAsset(ObjectPath);
+		if (RemovedItem.IsValid())
+		{
+			Catalog->RemoveMaterialFromFolder(RemovedItem, RemovedItem->OrganizedPath);
+		}
+	}
+	PendingRemovedAssets.Empty();
+	
+	for (const auto& AssetPair : PendingAddedAssets)
 	{
-		ProcessMaterialAsset(AssetData);
+		TSharedPtr<FMaterialVaultMaterialItem> ExistingItem = Catalog->MaterialMap.FindRef(AssetPair.Key);
+		FString PreviousPath = ExistingItem.IsValid() ? ExistingItem->OrganizedPath : FString();
+		
+		TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = ProcessMaterialAsset(AssetPair.Value);
+		
+		// Updates that keep the item in the same folder don't touch the tree
+		if (ExistingItem.IsValid())
+		{
+			if (MaterialItem->OrganizedPath == PreviousPath)
+			{
+				continue;
+			}
+			
+			Catalog->RemoveMaterialFromFolder(MaterialItem, PreviousPath);
+		}
+		
+		Catalog->AddMaterialToFolder(MaterialItem);
 	}
+	PendingAddedAssets.Empty();
+	
+	MarkSnapshotDirty();
+	OnRefreshRequested.Broadcast();
+}
+
+bool UMaterialVaultManager::IsMaterialAsset(const FAssetData& AssetData) const
+{
+	return AssetData.AssetClassPath == UMaterial::StaticClass()->GetClassPathName() ||
+		AssetData.AssetClassPath == UMaterialInstance::StaticClass()->GetClassPathName() ||
+		AssetData.AssetClassPath == UMaterialInstanceConstant::StaticClass()->GetClassPathName();
 }
 
-void UMaterialVaultManager::ProcessMaterialAsset(const FAssetData& AssetData)
+TSharedPtr<FMaterialVaultMaterialItem> UMaterialVaultManager::ProcessMaterialAsset(const FAssetData& AssetData)
 {
 	FString ObjectPath = AssetData.GetObjectPathString();
 	
 	// Create or update material item
-	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = MaterialMap.FindRef(ObjectPath);
+	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem = Catalog->MaterialMap.FindRef(ObjectPath);
 	if (!MaterialItem.IsValid())
 	{
 		MaterialItem = MakeShared<FMaterialVaultMaterialItem>(AssetData);
-		MaterialMap.Add(ObjectPath, MaterialItem);
+		Catalog->MaterialMap.Add(ObjectPath, MaterialItem);
 	}
 	else
 	{
@@ -579,164 +1086,303 @@ void UMaterialVaultManager::ProcessMaterialAsset(const FAssetData& AssetData)
 		MaterialItem->MaterialPtr = AssetData.ToSoftObjectPath();
 		MaterialItem->DisplayName = AssetData.AssetName.ToString();
 	}
+	MaterialItem->OrganizedPath = FMaterialVaultCatalog::OrganizePackagePath(AssetData.PackagePath.ToString());
 	
 	// Load metadata
 	LoadMaterialMetadata(MaterialItem);
+	
+	// The saved hash, sizes and reverse texture index keep their old values until the new walk lands,
+	// a walk already in flight read the package before this change and is redone
+	if (PendingDependencyRequests.Contains(ObjectPath))
+	{
+		SupersededDependencyRequests.Add(ObjectPath);
+	}
+	MaterialItem->bDependenciesResolved = false;
+	RequestMaterialDependencies(MaterialItem);
+	
+	return MaterialItem;
 }
 
-void UMaterialVaultManager::RemoveMaterialAsset(const FAssetData& AssetData)
+TSharedPtr<FMaterialVaultMaterialItem> UMaterialVaultManager::RemoveMaterialAsset(const FString& ObjectPath)
 {
-	FString ObjectPath = AssetData.GetObjectPathString();
-	MaterialMap.Remove(ObjectPath);
-	MetadataCache.Remove(ObjectPath);
+	TSharedPtr<FMaterialVaultMaterialItem> RemovedItem;
+	Catalog->MaterialMap.RemoveAndCopyValue(ObjectPath, RemovedItem);
+	if (RemovedItem.IsValid())
+	{
+		Catalog->UnindexMaterial(RemovedItem);
+	}
+	return RemovedItem;
 }
 
-TSharedPtr<FMaterialVaultFolderNode> UMaterialVaultManager::CreateFolderNode(const FString& FolderPath)
+bool UMaterialVaultManager::RestoreCatalogSnapshot()
 {
-	if (FolderPath.IsEmpty())
+	TArray<uint8> SnapshotData;
+	if (!FFileHelper::LoadFileToArray(SnapshotData, *FMaterialVaultSnapshot::GetSnapshotFilePath(), FILEREAD_Silent))
 	{
-		return nullptr;
+		return false;
 	}
 	
-	FString FolderName = FPaths::GetCleanFilename(FolderPath);
-	if (FolderName.IsEmpty())
+	TSharedPtr<FMaterialVaultCatalogBuild> Build = MakeShared<FMaterialVaultCatalogBuild>();
+	Build->Catalog = MakeShared<FMaterialVaultCatalog>(Settings.RootFolder);
+	if (!FMaterialVaultSnapshot::Read(SnapshotData, *Build))
 	{
-		FolderName = TEXT("Root");
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Ignoring outdated or corrupt catalog snapshot"));
+		return false;
 	}
 	
-	return MakeShared<FMaterialVaultFolderNode>(FolderName, FolderPath);
+	bCatalogNeedsValidation = true;
+	
+	StartCatalogBuild(Build);
+	return true;
 }
 
-TSharedPtr<FMaterialVaultFolderNode> UMaterialVaultManager::GetOrCreateFolderNode(const FString& FolderPath)
+void UMaterialVaultManager::SaveCatalogSnapshot(bool bAsync)
 {
-	// Check if folder already exists
-	if (FolderMap.Contains(FolderPath))
+	if (!Catalog.IsValid())
 	{
-		return FolderMap[FolderPath];
+		return;
 	}
 	
-	// Create new folder
-	TSharedPtr<FMaterialVaultFolderNode> NewFolder = CreateFolderNode(FolderPath);
-	if (!NewFolder.IsValid())
+	TArray<uint8> SnapshotData;
+	FMaterialVaultSnapshot::Write(*Catalog, SnapshotData);
+	bSnapshotDirty = false;
+	
+	// Never let two writes race on the same file
+	if (SnapshotWriteTask.IsValid())
 	{
-		return nullptr;
+		SnapshotWriteTask.Wait();
 	}
 	
-	// Add to map
-	FolderMap.Add(FolderPath, NewFolder);
-	
-	// Find parent folder
-	FString ParentPath = FPaths::GetPath(FolderPath);
-	if (!ParentPath.IsEmpty() && ParentPath != FolderPath)
+	FString SnapshotPath = FMaterialVaultSnapshot::GetSnapshotFilePath();
+	if (bAsync)
 	{
-		TSharedPtr<FMaterialVaultFolderNode> ParentFolder = GetOrCreateFolderNode(ParentPath);
-		if (ParentFolder.IsValid())
+		SnapshotWriteTask = Async(EAsyncExecution::ThreadPool, [SnapshotPath, SnapshotData = MoveTemp(SnapshotData)]()
 		{
-			NewFolder->Parent = ParentFolder;
-			ParentFolder->Children.Add(NewFolder);
-		}
+			FFileHelper::SaveArrayToFile(SnapshotData, *SnapshotPath);
+		});
 	}
 	else
 	{
-		// This is a root level folder
-		if (RootFolderNode.IsValid())
-		{
-			NewFolder->Parent = RootFolderNode;
-			RootFolderNode->Children.Add(NewFolder);
-		}
+		FFileHelper::SaveArrayToFile(SnapshotData, *SnapshotPath);
 	}
-	
-	return NewFolder;
 }
 
-void UMaterialVaultManager::SortMaterials(TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials) const
+void UMaterialVaultManager::ReconcileCatalogWithRegistry()
 {
-	switch (Settings.SortMode)
+	TSharedPtr<FMaterialVaultCatalogReconcile> Reconcile = MakeShared<FMaterialVaultCatalogReconcile>();
+	GatherMaterialAssets(Reconcile->MaterialAssets);
+	
+	// Only the hashes are copied, the worker never reads the live catalog
+	Reconcile->CatalogHashes.Reserve(Catalog->MaterialMap.Num());
+	for (const auto& MaterialPair : Catalog->MaterialMap)
 	{
-		case EMaterialVaultSortMode::Name:
-			Materials.Sort([](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
-			{
-				return A->DisplayName < B->DisplayName;
-			});
-			break;
-		case EMaterialVaultSortMode::DateModified:
-			Materials.Sort([](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
-			{
-				return A->Metadata.LastModified > B->Metadata.LastModified;
-			});
-			break;
-		case EMaterialVaultSortMode::Type:
-			Materials.Sort([](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
-			{
-				return A->AssetData.AssetClassPath.ToString() < B->AssetData.AssetClassPath.ToString();
-			});
-			break;
-		default:
-			break;
+		Reconcile->CatalogHashes.Add(MaterialPair.Value->AssetData.GetSoftObjectPath(), MaterialPair.Value->PackageSavedHash);
 	}
+	
+	// The registry snapshot supersedes the discovery events queued during the scan, later events wait for the result
+	PendingAddedAssets.Empty();
+	PendingRemovedAssets.Empty();
+	ActiveCatalogReconcile = Reconcile;
+	
+	TWeakObjectPtr<UMaterialVaultManager> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Reconcile]()
+	{
+		CompareCatalogWithRegistry(*Reconcile);
+		
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Reconcile]()
+		{
+			if (UMaterialVaultManager* Manager = WeakThis.Get())
+			{
+				Manager->OnCatalogReconciled(Reconcile);
+			}
+		});
+	});
 }
 
-FString UMaterialVaultManager::GetMetadataFilePath(const FAssetData& AssetData) const
+void UMaterialVaultManager::CompareCatalogWithRegistry(FMaterialVaultCatalogReconcile& Reconcile)
 {
-	FString ProjectDir = FPaths::ProjectDir();
-	FString MetadataDir = FPaths::Combine(ProjectDir, TEXT("Saved"), TEXT("MaterialVault"), TEXT("Metadata"));
+	const TArray<FAssetData>& MaterialAssets = Reconcile.MaterialAssets;
 	
-	FString AssetPath = AssetData.PackageName.ToString();
-	AssetPath.RemoveFromStart(TEXT("/Game/"));
-	AssetPath.ReplaceInline(TEXT("/"), TEXT("_"));
+	// Package hash lookups are the expensive part, each worker only touches its own slot
+	TArray<bool> ChangedFlags;
+	ChangedFlags.SetNumZeroed(MaterialAssets.Num());
+	ParallelFor(MaterialAssets.Num(), [&](int32 Index)
+	{
+		const FAssetData& AssetData = MaterialAssets[Index];
+		const FIoHash* CatalogHash = Reconcile.CatalogHashes.Find(AssetData.GetSoftObjectPath());
+		ChangedFlags[Index] = !CatalogHash || *CatalogHash != GetPackageSavedHash(AssetData.PackageName);
+	});
 	
-	FString MetadataFileName = FString::Printf(TEXT("%s_%s.json"), *AssetPath, *AssetData.AssetName.ToString());
+	// Hand back only assets that are new or whose package changed since the snapshot was written
+	TSet<FSoftObjectPath> RegistryPaths;
+	RegistryPaths.Reserve(MaterialAssets.Num());
+	for (int32 Index = 0; Index < MaterialAssets.Num(); ++Index)
+	{
+		RegistryPaths.Add(MaterialAssets[Index].GetSoftObjectPath());
+		if (ChangedFlags[Index])
+		{
+			Reconcile.ChangedAssets.Add(MaterialAssets[Index]);
+		}
+	}
 	
-	return FPaths::Combine(MetadataDir, MetadataFileName);
+	// Assets deleted while the editor was closed
+	for (const auto& HashPair : Reconcile.CatalogHashes)
+	{
+		if (!RegistryPaths.Contains(HashPair.Key))
+		{
+			Reconcile.RemovedPaths.Add(HashPair.Key.ToString());
+		}
+	}
 }
 
-FString UMaterialVaultManager::OrganizePackagePath(const FString& PackagePath) const
+void UMaterialVaultManager::OnCatalogReconciled(TSharedPtr<FMaterialVaultCatalogReconcile> Reconcile)
 {
-	// Organize package paths into Engine/Content/Plugins structure like Content Browser
-	if (PackagePath.StartsWith(TEXT("/Game")))
+	// A refresh started meanwhile rebuilds the catalog from the registry anyway
+	if (Reconcile != ActiveCatalogReconcile)
 	{
-		// Game content goes to Content folder
-		return PackagePath;
+		return;
 	}
-	else if (PackagePath.StartsWith(TEXT("/Engine")))
+	ActiveCatalogReconcile.Reset();
+	
+	// Events that arrived while the worker ran are newer than its registry snapshot and win
+	for (const FAssetData& AssetData : Reconcile->ChangedAssets)
 	{
-		// Engine content stays in Engine folder
-		return PackagePath;
+		FString ObjectPath = AssetData.GetObjectPathString();
+		if (!PendingAddedAssets.Contains(ObjectPath) && !PendingRemovedAssets.Contains(ObjectPath))
+		{
+			PendingAddedAssets.Add(MoveTemp(ObjectPath), AssetData);
+		}
 	}
-	else
+	for (const FString& ObjectPath : Reconcile->RemovedPaths)
 	{
-		// Check for plugin patterns - plugins typically start with plugin name
-		TArray<FString> PathComponents;
-		PackagePath.ParseIntoArray(PathComponents, TEXT("/"), true);
+		if (!PendingAddedAssets.Contains(ObjectPath))
+		{
+			PendingRemovedAssets.Add(ObjectPath);
+		}
+	}
+	
+	FlushPendingAssetEvents();
+}
+
+void UMaterialVaultManager::MarkSnapshotDirty()
+{
+	bSnapshotDirty = true;
+	LastCatalogChangeTime = FPlatformTime::Seconds();
+}
+
+FIoHash UMaterialVaultManager::GetPackageSavedHash(FName PackageName)
+{
+	// Safe to call from the catalog build workers, registry queries are internally locked
+	TOptional<FAssetPackageData> PackageData = IAssetRegistry::GetChecked().GetAssetPackageDataCopy(PackageName);
+	return PackageData.IsSet() ? PackageData->PackageSavedHash : FIoHash();
+}
+
+void UMaterialVaultManager::GetPackageSizes(FName PackageName, int64& OutDiskSize, int64& OutResourceSize)
+{
+	OutDiskSize = 0;
+	OutResourceSize = 0;
+	
+	// Walks hard package dependencies in the registry without loading anything, safe on the catalog build workers
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TSet<FName> VisitedPackages;
+	TArray<FName> PackagesToVisit;
+	TArray<FName> Dependencies;
+	VisitedPackages.Add(PackageName);
+	PackagesToVisit.Add(PackageName);
+	
+	while (PackagesToVisit.Num() > 0)
+	{
+		FName CurrentPackage = PackagesToVisit.Pop(EAllowShrinking::No);
 		
-		if (PathComponents.Num() > 0)
+		// Script packages have no package data and add nothing
+		TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(CurrentPackage);
+		if (PackageData.IsSet() && PackageData->DiskSize > 0)
 		{
-			FString FirstComponent = PathComponents[0];
-			
-			// Check if this looks like a plugin (not Engine, not Game, not Script)
-			if (!FirstComponent.Equals(TEXT("Engine"), ESearchCase::IgnoreCase) &&
-				!FirstComponent.Equals(TEXT("Game"), ESearchCase::IgnoreCase) &&
-				!FirstComponent.Equals(TEXT("Script"), ESearchCase::IgnoreCase) &&
-				!FirstComponent.Equals(TEXT("Temp"), ESearchCase::IgnoreCase) &&
-				!FirstComponent.Equals(TEXT("Memory"), ESearchCase::IgnoreCase))
+			if (CurrentPackage == PackageName)
 			{
-				// This is likely a plugin
-				return FString::Printf(TEXT("/Plugins%s"), *PackagePath);
+				OutDiskSize = PackageData->DiskSize;
 			}
+			OutResourceSize += PackageData->DiskSize;
 		}
 		
-		// Check if it starts with known engine patterns
-		if (PackagePath.StartsWith(TEXT("/Script")) || 
-			PackagePath.StartsWith(TEXT("/Temp")) ||
-			PackagePath.StartsWith(TEXT("/Memory")) ||
-			PackagePath.Contains(TEXT("Engine")))
+		Dependencies.Reset();
+		AssetRegistry.GetDependencies(CurrentPackage, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (FName Dependency : Dependencies)
 		{
-			return FString::Printf(TEXT("/Engine%s"), *PackagePath);
+			if (VisitedPackages.Num() < MaterialVaultMaxSizeDependencies && !VisitedPackages.Contains(Dependency))
+			{
+				VisitedPackages.Add(Dependency);
+				PackagesToVisit.Add(Dependency);
+			}
 		}
+	}
+}
+
+const TSet<FTopLevelAssetPath>& UMaterialVaultManager::GetTextureClassPaths()
+{
+	// Class hierarchy queries are game thread only, gather the texture classes once
+	if (TextureClassPaths.Num() == 0)
+	{
+		IAssetRegistry::GetChecked().GetDerivedClassNames({ UTexture2D::StaticClass()->GetClassPathName() }, {}, TextureClassPaths);
+	}
+	return TextureClassPaths;
+}
+
+void UMaterialVaultManager::GatherTextureDependencies(FName PackageName, const TSet<FTopLevelAssetPath>& TextureClassPaths, TArray<FSoftObjectPath>& OutTextures)
+{
+	// Follows hard package dependencies through parent materials, functions and layers; nothing is loaded
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TSet<FName> VisitedPackages;
+	TArray<FName> PackagesToVisit;
+	TArray<FName> Dependencies;
+	TArray<FAssetData> PackageAssets;
+	VisitedPackages.Add(PackageName);
+	PackagesToVisit.Add(PackageName);
+	
+	while (PackagesToVisit.Num() > 0)
+	{
+		FName CurrentPackage = PackagesToVisit.Pop(EAllowShrinking::No);
 		
-		// Unknown content, put in Content by default
-		return FString::Printf(TEXT("/Game%s"), *PackagePath);
+		Dependencies.Reset();
+		AssetRegistry.GetDependencies(CurrentPackage, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (FName Dependency : Dependencies)
+		{
+			if (VisitedPackages.Num() >= MaterialVaultMaxSizeDependencies || VisitedPackages.Contains(Dependency))
+			{
+				continue;
+			}
+			VisitedPackages.Add(Dependency);
+			
+			PackageAssets.Reset();
+			AssetRegistry.GetAssetsByPackageName(Dependency, PackageAssets, true);
+			
+			bool bIsTexturePackage = false;
+			for (const FAssetData& Asset : PackageAssets)
+			{
+				if (TextureClassPaths.Contains(Asset.AssetClassPath))
+				{
+					OutTextures.AddUnique(Asset.GetSoftObjectPath());
+					bIsTexturePackage = true;
+				}
+			}
+			
+			// Textures are leaves, and script packages have no assets to descend into
+			if (!bIsTexturePackage && PackageAssets.Num() > 0)
+			{
+				PackagesToVisit.Add(Dependency);
+			}
+		}
 	}
 }
 
+void UMaterialVaultManager::SortMaterials(TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials) const
+{
+	// Compares the precomputed sort keys, nothing is converted or allocated inside the sort
+	EMaterialVaultSortMode SortMode = Settings.SortMode;
+	Algo::Sort(Materials, [SortMode](const TSharedPtr<FMaterialVaultMaterialItem>& A, const TSharedPtr<FMaterialVaultMaterialItem>& B)
+	{
+		return FMaterialVaultCatalog::CompareMaterials(*A, *B, SortMode);
+	});
+}
+
 #undef LOCTEXT_NAMESPACE 
\ No newline at end of file
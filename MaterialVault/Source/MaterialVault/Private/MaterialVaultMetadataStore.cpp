@@ -0,0 +1,239 @@
+#include "MaterialVaultMetadataStore.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+
+static const uint32 MaterialVaultMetadataStoreMagic = 0x444D564D; // "MVMD"
+static const int32 MaterialVaultMetadataStoreVersion = 1;
+
+FMaterialVaultMetadataStore::FMaterialVaultMetadataStore()
+	: Log(GetStoreFilePath(), MaterialVaultMetadataStoreMagic, MaterialVaultMetadataStoreVersion)
+{
+}
+
+void FMaterialVaultMetadataStore::Initialize()
+{
+	FScopeLock LogScopeLock(&LogLock);
+	FScopeLock Lock(&RecordsLock);
+	
+	if (LoadLog())
+	{
+		return;
+	}
+	
+	// No usable store yet, import the legacy files and start a fresh log
+	Records.Empty();
+	int32 NumMigrated = MigrateLegacyMetadata();
+	if (NumMigrated > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("MaterialVault: Imported metadata for %d materials into %s"), NumMigrated, *GetStoreFilePath());
+	}
+	
+	Compact();
+}
+
+void FMaterialVaultMetadataStore::Shutdown()
+{
+	FScopeLock LogScopeLock(&LogLock);
+	FScopeLock Lock(&RecordsLock);
+	
+	if (Log.GetNumRecords() > Records.Num())
+	{
+		Compact();
+	}
+	
+	Records.Empty();
+}
+
+bool FMaterialVaultMetadataStore::Find(const FString& ObjectPath, FMaterialVaultMetadata& OutMetadata) const
+{
+	FScopeLock Lock(&RecordsLock);
+	
+	if (const FMaterialVaultMetadata* Metadata = Records.Find(ObjectPath))
+	{
+		OutMetadata = *Metadata;
+		return true;
+	}
+	return false;
+}
+
+void FMaterialVaultMetadataStore::Put(const FString& ObjectPath, const FMaterialVaultMetadata& Metadata)
+{
+	// Serialize before taking any lock, catalog workers reading records never wait on the file write
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+	FString RecordPath = ObjectPath;
+	FMaterialVaultMetadata RecordMetadata = Metadata;
+	SerializeRecord(PayloadWriter, RecordPath, RecordMetadata);
+	
+	FScopeLock LogScopeLock(&LogLock);
+	bool bAppended = Log.Append(Payload);
+	if (!bAppended)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Failed to append metadata for %s, rewriting store"), *ObjectPath);
+	}
+	
+	bool bNeedsCompact = !bAppended;
+	{
+		FScopeLock Lock(&RecordsLock);
+		Records.Add(ObjectPath, Metadata);
+		bNeedsCompact |= Log.NeedsCompaction(Records.Num());
+	}
+	
+	if (bNeedsCompact)
+	{
+		Compact();
+	}
+}
+
+void FMaterialVaultMetadataStore::Compact()
+{
+	FScopeLock LogScopeLock(&LogLock);
+	
+	// Copy the records out so lookups carry on while the log is written
+	TArray<TPair<FString, FMaterialVaultMetadata>> RecordsSnapshot;
+	{
+		FScopeLock Lock(&RecordsLock);
+		RecordsSnapshot = Records.Array();
+	}
+	
+	Log.Rewrite(RecordsSnapshot.Num(), [&RecordsSnapshot](int32 RecordIndex, TArray<uint8>& OutPayload)
+	{
+		FMemoryWriter PayloadWriter(OutPayload);
+		SerializeRecord(PayloadWriter, RecordsSnapshot[RecordIndex].Key, RecordsSnapshot[RecordIndex].Value);
+		return true;
+	}, [](const TArray<int64>&) {});
+}
+
+int32 FMaterialVaultMetadataStore::Num() const
+{
+	FScopeLock Lock(&RecordsLock);
+	return Records.Num();
+}
+
+bool FMaterialVaultMetadataStore::LoadLog()
+{
+	TMap<FString, FMaterialVaultMetadata> LoadedRecords;
+	bool bTruncated = false;
+	bool bLoaded = Log.Load([&LoadedRecords](FArchive& Reader)
+	{
+		FString ObjectPath;
+		FMaterialVaultMetadata Metadata;
+		SerializeRecord(Reader, ObjectPath, Metadata);
+		if (Reader.IsError())
+		{
+			return false;
+		}
+		
+		// Later records supersede earlier ones for the same material
+		LoadedRecords.Add(MoveTemp(ObjectPath), MoveTemp(Metadata));
+		return true;
+	}, bTruncated);
+	
+	if (!bLoaded)
+	{
+		return false;
+	}
+	
+	Records = MoveTemp(LoadedRecords);
+	if (bTruncated)
+	{
+		Compact();
+	}
+	return true;
+}
+
+void FMaterialVaultMetadataStore::SerializeRecord(FArchive& Ar, FString& ObjectPath, FMaterialVaultMetadata& Metadata)
+{
+	Ar << ObjectPath;
+	Ar << Metadata.MaterialName;
+	Ar << Metadata.Location;
+	Ar << Metadata.Author;
+	Ar << Metadata.LastModified;
+	Ar << Metadata.Notes;
+	Ar << Metadata.Tags;
+	Ar << Metadata.Category;
+}
+
+FString FMaterialVaultMetadataStore::GetStoreFilePath()
+{
+	return FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved"), TEXT("MaterialVault"), TEXT("Metadata.bin"));
+}
+
+int32 FMaterialVaultMetadataStore::MigrateLegacyMetadata()
+{
+	FString LegacyDir = FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved"), TEXT("MaterialVault"), TEXT("Metadata"));
+	
+	TArray<FString> LegacyFiles;
+	IFileManager::Get().FindFiles(LegacyFiles, *FPaths::Combine(LegacyDir, TEXT("*.json")), true, false);
+	
+	int32 NumMigrated = 0;
+	for (const FString& FileName : LegacyFiles)
+	{
+		FMaterialVaultMetadata Metadata;
+		if (!ReadLegacyMetadataFile(FPaths::Combine(LegacyDir, FileName), Metadata) || Metadata.Location.IsEmpty())
+		{
+			continue;
+		}
+		
+		// Files were named <package path with / as _>_<asset name>, and Location holds the package name
+		FString PackageName = Metadata.Location;
+		FString EncodedPackage = PackageName;
+		EncodedPackage.RemoveFromStart(TEXT("/Game/"));
+		EncodedPackage.ReplaceInline(TEXT("/"), TEXT("_"));
+		
+		FString AssetName = FPaths::GetBaseFilename(FileName);
+		if (!AssetName.RemoveFromStart(EncodedPackage + TEXT("_")) || AssetName.IsEmpty())
+		{
+			AssetName = FPackageName::GetShortName(PackageName);
+		}
+		
+		Records.Add(FString::Printf(TEXT("%s.%s"), *PackageName, *AssetName), MoveTemp(Metadata));
+		++NumMigrated;
+	}
+	
+	return NumMigrated;
+}
+
+bool FMaterialVaultMetadataStore::ReadLegacyMetadataFile(const FString& MetadataPath, FMaterialVaultMetadata& OutMetadata)
+{
+	FString FileContents;
+	if (!FFileHelper::LoadFileToString(FileContents, *MetadataPath))
+	{
+		return false;
+	}
+	
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FileContents);
+	
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		return false;
+	}
+	
+	OutMetadata.MaterialName = JsonObject->GetStringField(TEXT("MaterialName"));
+	OutMetadata.Location = JsonObject->GetStringField(TEXT("Location"));
+	OutMetadata.Author = JsonObject->GetStringField(TEXT("Author"));
+	OutMetadata.Notes = JsonObject->GetStringField(TEXT("Notes"));
+	OutMetadata.Category = JsonObject->GetStringField(TEXT("Category"));
+	
+	FString DateString = JsonObject->GetStringField(TEXT("LastModified"));
+	FDateTime::Parse(DateString, OutMetadata.LastModified);
+	
+	const TArray<TSharedPtr<FJsonValue>>* TagsArray;
+	if (JsonObject->TryGetArrayField(TEXT("Tags"), TagsArray))
+	{
+		OutMetadata.Tags.Empty();
+		for (const auto& TagValue : *TagsArray)
+		{
+			OutMetadata.Tags.Add(TagValue->AsString());
+		}
+	}
+	
+	return true;
+}
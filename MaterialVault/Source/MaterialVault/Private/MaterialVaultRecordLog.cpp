@@ -0,0 +1,175 @@
+#include "MaterialVaultRecordLog.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/ScopeRWLock.h"
+
+// Superseded records needed before the log is rewritten, so small logs are left alone
+static const int32 MaterialVaultRecordLogMinGarbage = 256;
+
+FMaterialVaultRecordLog::FMaterialVaultRecordLog(const FString& InFilePath, uint32 InMagic, int32 InVersion)
+	: FilePath(InFilePath)
+	, Magic(InMagic)
+	, Version(InVersion)
+	, NumRecords(0)
+{
+}
+
+bool FMaterialVaultRecordLog::Load(TFunctionRef<bool(FArchive& Reader)> ReadRecord, bool& bOutTruncated)
+{
+	bOutTruncated = false;
+	NumRecords = 0;
+	
+	// One buffered sequential pass, visitors may seek past payload bytes they don't keep
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath, FILEREAD_Silent));
+	if (!Reader)
+	{
+		return false;
+	}
+	
+	uint32 FileMagic = 0;
+	int32 FileVersion = 0;
+	*Reader << FileMagic << FileVersion;
+	if (Reader->IsError() || FileMagic != Magic || FileVersion != Version)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Ignoring unreadable record log %s"), *FilePath);
+		return false;
+	}
+	
+	int32 NumRead = 0;
+	while (!Reader->AtEnd())
+	{
+		int32 RecordSize = 0;
+		*Reader << RecordSize;
+		int64 RecordStart = Reader->Tell();
+		if (Reader->IsError() || RecordSize <= 0 || RecordStart + RecordSize > Reader->TotalSize())
+		{
+			bOutTruncated = true;
+			break;
+		}
+		
+		if (!ReadRecord(*Reader) || Reader->IsError() || Reader->Tell() != RecordStart + RecordSize)
+		{
+			bOutTruncated = true;
+			break;
+		}
+		++NumRead;
+	}
+	NumRecords = NumRead;
+	
+	// A write torn by a crash leaves a partial record at the end, the owner rewrites so new appends follow valid data
+	if (bOutTruncated)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Discarding incomplete record at the end of %s"), *FilePath);
+	}
+	
+	return true;
+}
+
+bool FMaterialVaultRecordLog::Append(const TArray<uint8>& Payload, int64* OutPayloadOffset)
+{
+	// Readers keep their handles open while this writes
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*FilePath, FILEWRITE_Append | FILEWRITE_AllowRead));
+	if (!FileWriter)
+	{
+		return false;
+	}
+	
+	int32 RecordSize = Payload.Num();
+	*FileWriter << RecordSize;
+	int64 PayloadOffset = FileWriter->Tell();
+	FileWriter->Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+	if (!FileWriter->Close())
+	{
+		return false;
+	}
+	
+	++NumRecords;
+	if (OutPayloadOffset)
+	{
+		*OutPayloadOffset = PayloadOffset;
+	}
+	return true;
+}
+
+bool FMaterialVaultRecordLog::Rewrite(int32 NumRecordsToWrite, TFunctionRef<bool(int32 RecordIndex, TArray<uint8>& OutPayload)> GetPayload, TFunctionRef<void(const TArray<int64>& PayloadOffsets)> OnSwapped)
+{
+	// Write next to the log and swap it in, so a crash mid-write never loses the current log
+	FString TempPath = FilePath + TEXT(".tmp");
+	TArray<int64> PayloadOffsets;
+	PayloadOffsets.Init(INDEX_NONE, NumRecordsToWrite);
+	int32 NumWritten = 0;
+	{
+		TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (!FileWriter)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Failed to write record log %s"), *FilePath);
+			return false;
+		}
+		
+		uint32 FileMagic = Magic;
+		int32 FileVersion = Version;
+		*FileWriter << FileMagic << FileVersion;
+		
+		TArray<uint8> Payload;
+		for (int32 RecordIndex = 0; RecordIndex < NumRecordsToWrite; ++RecordIndex)
+		{
+			Payload.Reset();
+			if (!GetPayload(RecordIndex, Payload) || Payload.Num() == 0)
+			{
+				continue;
+			}
+			
+			int32 RecordSize = Payload.Num();
+			*FileWriter << RecordSize;
+			PayloadOffsets[RecordIndex] = FileWriter->Tell();
+			FileWriter->Serialize(Payload.GetData(), Payload.Num());
+			++NumWritten;
+		}
+		
+		if (!FileWriter->Close())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Failed to write record log %s"), *FilePath);
+			return false;
+		}
+	}
+	
+	// No reader holds the old file open across the swap, and none sees the new one before the owner has its offsets
+	FWriteScopeLock WriteLock(FileLock);
+	if (!IFileManager::Get().Move(*FilePath, *TempPath, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Failed to replace record log %s"), *FilePath);
+		return false;
+	}
+	NumRecords = NumWritten;
+	OnSwapped(PayloadOffsets);
+	return true;
+}
+
+bool FMaterialVaultRecordLog::Read(TFunctionRef<bool(int64& OutOffset, int64& OutSize)> Locate, TArray<uint8>& OutData) const
+{
+	FReadScopeLock ReadLock(FileLock);
+	
+	int64 Offset = 0;
+	int64 Size = 0;
+	if (!Locate(Offset, Size) || Offset <= 0 || Size < 0)
+	{
+		return false;
+	}
+	
+	// A plain handle per read, workers read in parallel and nothing is buffered beyond the bytes asked for
+	TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath, true));
+	if (!FileHandle || Offset + Size > FileHandle->Size() || !FileHandle->Seek(Offset))
+	{
+		return false;
+	}
+	
+	OutData.SetNumUninitialized(Size);
+	return FileHandle->Read(OutData.GetData(), Size);
+}
+
+bool FMaterialVaultRecordLog::NeedsCompaction(int32 NumLiveRecords) const
+{
+	int32 NumGarbage = NumRecords - NumLiveRecords;
+	return NumGarbage > NumLiveRecords && NumGarbage >= MaterialVaultRecordLogMinGarbage;
+}
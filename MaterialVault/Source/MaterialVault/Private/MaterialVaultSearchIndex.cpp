@@ -0,0 +1,448 @@
+#include "MaterialVaultSearchIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "String/Find.h"
+
+// Joins the fields of a material's search text, never typed into the search box so matches can't span two fields
+static const TCHAR MaterialVaultSearchFieldSeparator = TEXT('\n');
+
+// Items scored between checks of the cancellation flag
+static const int32 MaterialVaultRankCancelCheckInterval = 1024;
+
+// Score bands, so any name substring match outranks any subsequence match and so on down
+static const int32 MaterialVaultFuzzySubstringScore = 3000;
+static const int32 MaterialVaultFuzzySubsequenceScore = 1000;
+static const int32 MaterialVaultFuzzyEditScore = 500;
+static const int32 MaterialVaultFuzzyMetadataScore = 300;
+
+/** A scored document kept in the bounded top-K heap */
+struct FMaterialVaultRankedMatch
+{
+	int32 Score;
+	
+	// Document id, or position in the array being ranked
+	int32 Index;
+	
+	// Lowest score at the heap top so it is the one evicted
+	bool operator<(const FMaterialVaultRankedMatch& Other) const
+	{
+		return Score != Other.Score ? Score < Other.Score : Index > Other.Index;
+	}
+};
+
+static void PushRankedMatch(TArray<FMaterialVaultRankedMatch>& Heap, const FMaterialVaultRankedMatch& Match, int32 MaxResults)
+{
+	if (Heap.Num() < MaxResults)
+	{
+		Heap.HeapPush(Match);
+	}
+	else if (Heap.HeapTop() < Match)
+	{
+		Heap.HeapPopDiscard(EAllowShrinking::No);
+		Heap.HeapPush(Match);
+	}
+}
+
+static bool IsWordStart(FStringView Text, int32 Index)
+{
+	return Index == 0 || !FChar::IsAlnum(Text[Index - 1]);
+}
+
+// Typos allowed by the edit distance band, about one per four characters
+static int32 GetMaxEditDistance(int32 QueryLength)
+{
+	return FMath::Max(1, QueryLength / 4);
+}
+
+void FMaterialVaultSearchIndex::IndexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	if (!MaterialItem.IsValid())
+	{
+		return;
+	}
+	
+	FString SearchText = BuildSearchText(*MaterialItem);
+	
+	if (const int32* ExistingId = DocumentIds.Find(MaterialItem))
+	{
+		FString& ExistingText = DocumentText[*ExistingId];
+		if (ExistingText.Equals(SearchText, ESearchCase::CaseSensitive))
+		{
+			return;
+		}
+		
+		RemovePostings(ExistingText, *ExistingId);
+		AddPostings(SearchText, *ExistingId);
+		ExistingText = MoveTemp(SearchText);
+		return;
+	}
+	
+	int32 DocumentId;
+	if (FreeDocumentIds.Num() > 0)
+	{
+		DocumentId = FreeDocumentIds.Pop(EAllowShrinking::No);
+		Documents[DocumentId] = MaterialItem;
+	}
+	else
+	{
+		DocumentId = Documents.Add(MaterialItem);
+		DocumentText.AddDefaulted();
+	}
+	
+	DocumentIds.Add(MaterialItem, DocumentId);
+	AddPostings(SearchText, DocumentId);
+	DocumentText[DocumentId] = MoveTemp(SearchText);
+}
+
+void FMaterialVaultSearchIndex::RemoveMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem)
+{
+	int32 DocumentId = INDEX_NONE;
+	if (!DocumentIds.RemoveAndCopyValue(MaterialItem, DocumentId))
+	{
+		return;
+	}
+	
+	RemovePostings(DocumentText[DocumentId], DocumentId);
+	Documents[DocumentId].Reset();
+	DocumentText[DocumentId].Empty();
+	FreeDocumentIds.Add(DocumentId);
+}
+
+void FMaterialVaultSearchIndex::Search(const FString& SearchTerm, TArray<TSharedPtr<FMaterialVaultMaterialItem>>& OutResults) const
+{
+	OutResults.Reset();
+	
+	FString Query = SearchTerm.ToLower();
+	if (Query.IsEmpty())
+	{
+		return;
+	}
+	
+	// Too short for a trigram, scan the stored text directly
+	if (Query.Len() < 3)
+	{
+		for (int32 DocumentId = 0; DocumentId < Documents.Num(); ++DocumentId)
+		{
+			if (Documents[DocumentId].IsValid() && DocumentText[DocumentId].Contains(Query, ESearchCase::CaseSensitive))
+			{
+				OutResults.Add(Documents[DocumentId]);
+			}
+		}
+		return;
+	}
+	
+	TArray<uint64> QueryTrigrams;
+	GatherTrigrams(Query, QueryTrigrams);
+	
+	TArray<const TArray<int32>*, TInlineAllocator<32>> PostingLists;
+	for (uint64 Trigram : QueryTrigrams)
+	{
+		const TArray<int32>* PostingList = Postings.Find(Trigram);
+		if (!PostingList)
+		{
+			// A trigram no material contains, nothing can match
+			return;
+		}
+		PostingLists.Add(PostingList);
+	}
+	
+	// Intersect starting from the shortest list so the candidate set shrinks as fast as possible
+	Algo::SortBy(PostingLists, [](const TArray<int32>* PostingList) { return PostingList->Num(); });
+	
+	TArray<int32> Candidates = *PostingLists[0];
+	for (int32 ListIndex = 1; ListIndex < PostingLists.Num() && Candidates.Num() > 0; ++ListIndex)
+	{
+		const TArray<int32>& PostingList = *PostingLists[ListIndex];
+		int32 NumKept = 0;
+		int32 PostingIndex = 0;
+		for (int32 Candidate : Candidates)
+		{
+			while (PostingIndex < PostingList.Num() && PostingList[PostingIndex] < Candidate)
+			{
+				++PostingIndex;
+			}
+			if (PostingIndex == PostingList.Num())
+			{
+				break;
+			}
+			if (PostingList[PostingIndex] == Candidate)
+			{
+				Candidates[NumKept++] = Candidate;
+			}
+		}
+		Candidates.SetNum(NumKept, EAllowShrinking::No);
+	}
+	
+	// Sharing every trigram doesn't guarantee the trigrams are contiguous, confirm against the text
+	for (int32 DocumentId : Candidates)
+	{
+		if (DocumentText[DocumentId].Contains(Query, ESearchCase::CaseSensitive))
+		{
+			OutResults.Add(Documents[DocumentId]);
+		}
+	}
+}
+
+bool FMaterialVaultSearchIndex::RankSearchTexts(const TArray<FString>& SearchTexts, const FString& SearchTerm, int32 MaxResults, TArray<int32>& OutIndices, const FThreadSafeBool* bCancelled)
+{
+	OutIndices.Reset();
+	
+	FString Query = SearchTerm.ToLower();
+	if (Query.IsEmpty() || MaxResults <= 0)
+	{
+		return true;
+	}
+	
+	TArray<FMaterialVaultRankedMatch> Heap;
+	Heap.Reserve(FMath::Min(MaxResults, SearchTexts.Num()));
+	
+	for (int32 TextIndex = 0; TextIndex < SearchTexts.Num(); ++TextIndex)
+	{
+		if (bCancelled && TextIndex % MaterialVaultRankCancelCheckInterval == 0 && *bCancelled)
+		{
+			return false;
+		}
+		
+		int32 Score = ScoreSearchText(Query, SearchTexts[TextIndex]);
+		if (Score > 0)
+		{
+			PushRankedMatch(Heap, { Score, TextIndex }, MaxResults);
+		}
+	}
+	
+	Heap.Sort([](const FMaterialVaultRankedMatch& A, const FMaterialVaultRankedMatch& B) { return B < A; });
+	OutIndices.Reserve(Heap.Num());
+	for (const FMaterialVaultRankedMatch& Match : Heap)
+	{
+		OutIndices.Add(Match.Index);
+	}
+	return true;
+}
+
+int32 FMaterialVaultSearchIndex::ScoreFuzzyMatch(FStringView Query, FStringView Text)
+{
+	if (Query.IsEmpty() || Text.IsEmpty())
+	{
+		return 0;
+	}
+	
+	// Shorter names win ties within each band
+	int32 LengthPenalty = FMath::Min(FMath::Max(Text.Len() - Query.Len(), 0), 99);
+	
+	// Exact substring, best at the start or at a word boundary
+	int32 FoundIndex = UE::String::FindFirst(Text, Query, ESearchCase::CaseSensitive);
+	if (FoundIndex != INDEX_NONE)
+	{
+		int32 Bonus = FoundIndex == 0 ? 500 : (IsWordStart(Text, FoundIndex) ? 250 : 0);
+		return MaterialVaultFuzzySubstringScore + Bonus - FMath::Min(FoundIndex, 99) - LengthPenalty;
+	}
+	
+	// In-order subsequence, rewarding consecutive runs and matches on word starts
+	int32 QueryIndex = 0;
+	int32 LastMatchIndex = INDEX_NONE;
+	int32 SubsequenceScore = 0;
+	for (int32 TextIndex = 0; TextIndex < Text.Len() && QueryIndex < Query.Len(); ++TextIndex)
+	{
+		if (Text[TextIndex] != Query[QueryIndex])
+		{
+			continue;
+		}
+		
+		SubsequenceScore += 10;
+		if (LastMatchIndex != INDEX_NONE && TextIndex == LastMatchIndex + 1)
+		{
+			SubsequenceScore += 15;
+		}
+		if (IsWordStart(Text, TextIndex))
+		{
+			SubsequenceScore += TextIndex == 0 ? 45 : 20;
+		}
+		LastMatchIndex = TextIndex;
+		++QueryIndex;
+	}
+	if (QueryIndex == Query.Len())
+	{
+		return MaterialVaultFuzzySubsequenceScore + FMath::Min(SubsequenceScore, 1699) - LengthPenalty;
+	}
+	
+	// Typos: edit distance against the best-matching part of the text, about one edit per four characters
+	if (Query.Len() >= 3)
+	{
+		int32 MaxDistance = GetMaxEditDistance(Query.Len());
+		int32 Distance = GetSubstringEditDistance(Query, Text, MaxDistance);
+		if (Distance <= MaxDistance)
+		{
+			return MaterialVaultFuzzyEditScore + (MaxDistance - Distance) * 100 / MaxDistance + 99 - LengthPenalty;
+		}
+	}
+	
+	return 0;
+}
+
+int32 FMaterialVaultSearchIndex::ScoreSearchText(FStringView Query, FStringView SearchText)
+{
+	// The name is the first field, the rest only counts for exact substrings
+	int32 SeparatorIndex = INDEX_NONE;
+	FStringView NameText = SearchText;
+	if (SearchText.FindChar(MaterialVaultSearchFieldSeparator, SeparatorIndex))
+	{
+		NameText = SearchText.Left(SeparatorIndex);
+	}
+	
+	int32 NameScore = ScoreFuzzyMatch(Query, NameText);
+	if (NameScore > 0)
+	{
+		return NameScore;
+	}
+	
+	return UE::String::FindFirst(SearchText, Query, ESearchCase::CaseSensitive) != INDEX_NONE ? MaterialVaultFuzzyMetadataScore : 0;
+}
+
+int32 FMaterialVaultSearchIndex::GetSubstringEditDistance(FStringView Query, FStringView Text, int32 MaxDistance)
+{
+	// Levenshtein distance where the match may start and end anywhere in the text, two rows over the text
+	TArray<int32, TInlineAllocator<128>> PreviousRow;
+	TArray<int32, TInlineAllocator<128>> CurrentRow;
+	PreviousRow.SetNumZeroed(Text.Len() + 1);
+	CurrentRow.SetNumUninitialized(Text.Len() + 1);
+	
+	for (int32 QueryIndex = 1; QueryIndex <= Query.Len(); ++QueryIndex)
+	{
+		CurrentRow[0] = QueryIndex;
+		int32 RowMinimum = CurrentRow[0];
+		for (int32 TextIndex = 1; TextIndex <= Text.Len(); ++TextIndex)
+		{
+			int32 SubstitutionCost = Query[QueryIndex - 1] == Text[TextIndex - 1] ? 0 : 1;
+			CurrentRow[TextIndex] = FMath::Min3(PreviousRow[TextIndex] + 1, CurrentRow[TextIndex - 1] + 1, PreviousRow[TextIndex - 1] + SubstitutionCost);
+			RowMinimum = FMath::Min(RowMinimum, CurrentRow[TextIndex]);
+		}
+		
+		// Distances never shrink from one row to the next, stop once nothing can come in under the limit
+		if (RowMinimum > MaxDistance)
+		{
+			return RowMinimum;
+		}
+		Swap(PreviousRow, CurrentRow);
+	}
+	
+	int32 Distance = MAX_int32;
+	for (int32 Cost : PreviousRow)
+	{
+		Distance = FMath::Min(Distance, Cost);
+	}
+	return Distance;
+}
+
+void FMaterialVaultSearchIndex::GetSearchTexts(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials, TArray<FString>& OutSearchTexts) const
+{
+	// Indexed materials copy the text already built for them, only materials outside the catalog are built here
+	OutSearchTexts.Reset(Materials.Num());
+	for (const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem : Materials)
+	{
+		if (const int32* DocumentId = DocumentIds.Find(MaterialItem))
+		{
+			OutSearchTexts.Add(DocumentText[*DocumentId]);
+		}
+		else
+		{
+			OutSearchTexts.Add(MaterialItem.IsValid() ? BuildSearchText(*MaterialItem) : FString());
+		}
+	}
+}
+
+int32 FMaterialVaultSearchIndex::Num() const
+{
+	return DocumentIds.Num();
+}
+
+FString FMaterialVaultSearchIndex::BuildSearchText(const FMaterialVaultMaterialItem& MaterialItem)
+{
+	const FMaterialVaultMetadata& Metadata = MaterialItem.Metadata;
+	
+	FString SearchText;
+	SearchText.Reserve(256);
+	SearchText += MaterialItem.DisplayName;
+	SearchText += MaterialVaultSearchFieldSeparator;
+	SearchText += MaterialItem.AssetData.PackagePath.ToString();
+	for (const FString& Tag : Metadata.Tags)
+	{
+		SearchText += MaterialVaultSearchFieldSeparator;
+		SearchText += Tag;
+	}
+	SearchText += MaterialVaultSearchFieldSeparator;
+	SearchText += Metadata.Category;
+	SearchText += MaterialVaultSearchFieldSeparator;
+	SearchText += Metadata.Author;
+	SearchText += MaterialVaultSearchFieldSeparator;
+	SearchText += Metadata.Notes;
+	
+	SearchText.ToLowerInline();
+	return SearchText;
+}
+
+void FMaterialVaultSearchIndex::GatherTrigrams(const FString& Text, TArray<uint64>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+	
+	// Three 21-bit code points packed into one key
+	const TCHAR* Chars = *Text;
+	for (int32 Index = 0; Index + 2 < Text.Len(); ++Index)
+	{
+		uint64 Trigram = ((uint64)(Chars[Index] & 0x1FFFFF) << 42) | ((uint64)(Chars[Index + 1] & 0x1FFFFF) << 21) | (uint64)(Chars[Index + 2] & 0x1FFFFF);
+		OutTrigrams.Add(Trigram);
+	}
+	
+	// Each trigram once per text
+	Algo::Sort(OutTrigrams);
+	int32 NumUnique = 0;
+	for (int32 Index = 0; Index < OutTrigrams.Num(); ++Index)
+	{
+		if (NumUnique == 0 || OutTrigrams[NumUnique - 1] != OutTrigrams[Index])
+		{
+			OutTrigrams[NumUnique++] = OutTrigrams[Index];
+		}
+	}
+	OutTrigrams.SetNum(NumUnique, EAllowShrinking::No);
+}
+
+void FMaterialVaultSearchIndex::AddPostings(const FString& Text, int32 DocumentId)
+{
+	TArray<uint64> Trigrams;
+	GatherTrigrams(Text, Trigrams);
+	
+	for (uint64 Trigram : Trigrams)
+	{
+		// Ids mostly arrive in increasing order during a build, making this an append
+		TArray<int32>& PostingList = Postings.FindOrAdd(Trigram);
+		int32 InsertIndex = Algo::LowerBound(PostingList, DocumentId);
+		if (InsertIndex == PostingList.Num() || PostingList[InsertIndex] != DocumentId)
+		{
+			PostingList.Insert(DocumentId, InsertIndex);
+		}
+	}
+}
+
+void FMaterialVaultSearchIndex::RemovePostings(const FString& Text, int32 DocumentId)
+{
+	TArray<uint64> Trigrams;
+	GatherTrigrams(Text, Trigrams);
+	
+	for (uint64 Trigram : Trigrams)
+	{
+		TArray<int32>* PostingList = Postings.Find(Trigram);
+		if (!PostingList)
+		{
+			continue;
+		}
+		
+		int32 RemoveIndex = Algo::BinarySearch(*PostingList, DocumentId);
+		if (RemoveIndex != INDEX_NONE)
+		{
+			PostingList->RemoveAt(RemoveIndex, 1, EAllowShrinking::No);
+		}
+		if (PostingList->Num() == 0)
+		{
+			Postings.Remove(Trigram);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#include "MaterialVaultSnapshot.h"
+#include "MaterialVaultCatalog.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static const uint32 MaterialVaultSnapshotMagic = 0x5856564D; // "MVVX"
+
+// Bump whenever the layout below changes, older snapshots are then ignored and rebuilt
+static const int32 MaterialVaultSnapshotVersion = 4;
+
+void FMaterialVaultSnapshot::Write(const FMaterialVaultCatalog& Catalog, TArray<uint8>& OutData)
+{
+	FMemoryWriter Writer(OutData);
+	
+	uint32 Magic = MaterialVaultSnapshotMagic;
+	int32 Version = MaterialVaultSnapshotVersion;
+	int32 NumEntries = Catalog.MaterialMap.Num();
+	Writer << Magic << Version << NumEntries;
+	
+	for (const auto& MaterialPair : Catalog.MaterialMap)
+	{
+		const FMaterialVaultMaterialItem& MaterialItem = *MaterialPair.Value;
+		
+		FString PackageName = MaterialItem.AssetData.PackageName.ToString();
+		FString PackagePath = MaterialItem.AssetData.PackagePath.ToString();
+		FString AssetName = MaterialItem.AssetData.AssetName.ToString();
+		FString AssetClassPath = MaterialItem.AssetData.AssetClassPath.ToString();
+		FIoHash PackageSavedHash = MaterialItem.PackageSavedHash;
+		int64 DiskSize = MaterialItem.DiskSize;
+		int64 ResourceSize = MaterialItem.ResourceSize;
+		Writer << PackageName << PackagePath << AssetName << AssetClassPath << PackageSavedHash << DiskSize << ResourceSize;
+		
+		// Texture paths are stored as strings so reading never resolves redirectors or touches packages
+		bool bDependenciesResolved = MaterialItem.bDependenciesResolved;
+		TArray<FString> TexturePaths;
+		for (const TSoftObjectPtr<UTexture2D>& Texture : MaterialItem.TextureDependencies)
+		{
+			TexturePaths.Add(Texture.ToString());
+		}
+		Writer << bDependenciesResolved << TexturePaths;
+	}
+}
+
+bool FMaterialVaultSnapshot::Read(const TArray<uint8>& Data, FMaterialVaultCatalogBuild& OutBuild)
+{
+	FMemoryReader Reader(Data);
+	
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 NumEntries = 0;
+	Reader << Magic << Version << NumEntries;
+	if (Reader.IsError() || Magic != MaterialVaultSnapshotMagic || Version != MaterialVaultSnapshotVersion || NumEntries < 0)
+	{
+		return false;
+	}
+	
+	OutBuild.MaterialAssets.Reserve(NumEntries);
+	OutBuild.KnownPackages.Reserve(NumEntries);
+	
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		FString PackageName;
+		FString PackagePath;
+		FString AssetName;
+		FString AssetClassPath;
+		FMaterialVaultPackageInfo PackageInfo;
+		TArray<FString> TexturePaths;
+		Reader << PackageName << PackagePath << AssetName << AssetClassPath << PackageInfo.SavedHash << PackageInfo.DiskSize << PackageInfo.ResourceSize;
+		Reader << PackageInfo.bDependenciesResolved << TexturePaths;
+		
+		// Truncated or corrupt files are rejected as a whole
+		if (Reader.IsError())
+		{
+			return false;
+		}
+		
+		PackageInfo.TextureDependencies.Reserve(TexturePaths.Num());
+		for (const FString& TexturePath : TexturePaths)
+		{
+			PackageInfo.TextureDependencies.Emplace(TexturePath);
+		}
+		
+		FTopLevelAssetPath ClassPath;
+		ClassPath.TrySetPath(AssetClassPath);
+		
+		const FAssetData& AssetData = OutBuild.MaterialAssets.Emplace_GetRef(FName(*PackageName), FName(*PackagePath), FName(*AssetName), ClassPath);
+		OutBuild.KnownPackages.Add(AssetData.PackageName, PackageInfo);
+	}
+	
+	OutBuild.bRestoredFromSnapshot = true;
+	return true;
+}
+
+FString FMaterialVaultSnapshot::GetSnapshotFilePath()
+{
+	return FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved"), TEXT("MaterialVault"), TEXT("VaultIndex.bin"));
+}
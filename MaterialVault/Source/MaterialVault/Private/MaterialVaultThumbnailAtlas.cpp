@@ -0,0 +1,241 @@
+#include "MaterialVaultThumbnailAtlas.h"
+#include "MaterialVaultThumbnailManager.h"
+#include "Engine/Texture2D.h"
+#include "TextureResource.h"
+
+// Page edge length, one page holds 49 thumbnails at 256px and many more of the smaller levels
+static const int32 MaterialVaultAtlasPageSize = 2048;
+
+// Edge pixels are repeated into this border so filtering never picks up a neighbouring thumbnail
+static const int32 MaterialVaultAtlasPadding = 1;
+
+FMaterialVaultThumbnailAtlas::FMaterialVaultThumbnailAtlas()
+{
+}
+
+FMaterialVaultThumbnailAtlas::~FMaterialVaultThumbnailAtlas()
+{
+}
+
+TSharedPtr<FSlateBrush> FMaterialVaultThumbnailAtlas::Add(const FMaterialVaultThumbnailImage& Image, FMaterialVaultAtlasSlot& OutSlot)
+{
+	if (Image.Width <= 0 || Image.Height <= 0)
+	{
+		return nullptr;
+	}
+	
+	// Slots are square so shelves of one size can hand freed space to any thumbnail of that size
+	int32 SlotSize = FMath::Max(Image.Width, Image.Height) + MaterialVaultAtlasPadding * 2;
+	int32 SlotY = 0;
+	if (!Allocate(SlotSize, OutSlot, SlotY))
+	{
+		return nullptr;
+	}
+	
+	UTexture2D* Texture = Pages[OutSlot.PageIndex].Texture;
+	UploadSlot(Texture, OutSlot.X, SlotY, Image);
+	
+	// The brush samples the page through a UV sub-rectangle, so thumbnails on one page share a resource
+	float PageSize = (float)MaterialVaultAtlasPageSize;
+	FVector2f UVMin((OutSlot.X + MaterialVaultAtlasPadding) / PageSize, (SlotY + MaterialVaultAtlasPadding) / PageSize);
+	FVector2f UVMax(UVMin.X + Image.Width / PageSize, UVMin.Y + Image.Height / PageSize);
+	
+	TSharedPtr<FSlateBrush> Brush = MakeShared<FSlateBrush>();
+	Brush->SetResourceObject(Texture);
+	Brush->ImageSize = FVector2D(Image.Width, Image.Height);
+	Brush->SetUVRegion(FBox2f(UVMin, UVMax));
+	return Brush;
+}
+
+void FMaterialVaultThumbnailAtlas::Release(const FMaterialVaultAtlasSlot& Slot, TSharedPtr<FSlateBrush> Brush)
+{
+	if (!Slot.IsValid())
+	{
+		return;
+	}
+	
+	FPendingRelease& PendingRelease = PendingReleases.AddDefaulted_GetRef();
+	PendingRelease.Slot = Slot;
+	PendingRelease.Brush = MoveTemp(Brush);
+}
+
+void FMaterialVaultThumbnailAtlas::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (FPage& Page : Pages)
+	{
+		Collector.AddReferencedObject(Page.Texture);
+	}
+}
+
+FString FMaterialVaultThumbnailAtlas::GetReferencerName() const
+{
+	return TEXT("FMaterialVaultThumbnailAtlas");
+}
+
+bool FMaterialVaultThumbnailAtlas::Allocate(int32 SlotSize, FMaterialVaultAtlasSlot& OutSlot, int32& OutY)
+{
+	if (SlotSize > MaterialVaultAtlasPageSize)
+	{
+		return false;
+	}
+	
+	FlushPendingReleases();
+	
+	for (int32 PageIndex = 0; PageIndex < Pages.Num(); ++PageIndex)
+	{
+		if (AllocateInPage(PageIndex, SlotSize, OutSlot, OutY))
+		{
+			return true;
+		}
+	}
+	
+	FPage& Page = Pages.AddDefaulted_GetRef();
+	Page.Texture = CreatePageTexture();
+	if (!Page.Texture)
+	{
+		Pages.Pop();
+		return false;
+	}
+	
+	return AllocateInPage(Pages.Num() - 1, SlotSize, OutSlot, OutY);
+}
+
+bool FMaterialVaultThumbnailAtlas::AllocateInPage(int32 PageIndex, int32 SlotSize, FMaterialVaultAtlasSlot& OutSlot, int32& OutY)
+{
+	FPage& Page = Pages[PageIndex];
+	
+	// Reuse a freed slot or extend a shelf of the same size
+	for (int32 ShelfIndex = 0; ShelfIndex < Page.Shelves.Num(); ++ShelfIndex)
+	{
+		FShelf& Shelf = Page.Shelves[ShelfIndex];
+		if (Shelf.SlotSize != SlotSize)
+		{
+			continue;
+		}
+		
+		if (Shelf.FreeX.Num() > 0)
+		{
+			OutSlot.X = Shelf.FreeX.Pop(EAllowShrinking::No);
+		}
+		else if (Shelf.NextX + SlotSize <= MaterialVaultAtlasPageSize)
+		{
+			OutSlot.X = Shelf.NextX;
+			Shelf.NextX += SlotSize;
+		}
+		else
+		{
+			continue;
+		}
+		
+		OutSlot.PageIndex = PageIndex;
+		OutSlot.ShelfIndex = ShelfIndex;
+		OutY = Shelf.Y;
+		++Page.NumSlots;
+		return true;
+	}
+	
+	// Open a new shelf below the last one
+	if (Page.NextShelfY + SlotSize > MaterialVaultAtlasPageSize)
+	{
+		return false;
+	}
+	
+	FShelf& Shelf = Page.Shelves.AddDefaulted_GetRef();
+	Shelf.Y = Page.NextShelfY;
+	Shelf.SlotSize = SlotSize;
+	Shelf.NextX = SlotSize;
+	Page.NextShelfY += SlotSize;
+	
+	OutSlot.PageIndex = PageIndex;
+	OutSlot.ShelfIndex = Page.Shelves.Num() - 1;
+	OutSlot.X = 0;
+	OutY = Shelf.Y;
+	++Page.NumSlots;
+	return true;
+}
+
+void FMaterialVaultThumbnailAtlas::FreeSlot(const FMaterialVaultAtlasSlot& Slot)
+{
+	if (!Pages.IsValidIndex(Slot.PageIndex))
+	{
+		return;
+	}
+	
+	FPage& Page = Pages[Slot.PageIndex];
+	if (!Page.Shelves.IsValidIndex(Slot.ShelfIndex))
+	{
+		return;
+	}
+	
+	Page.Shelves[Slot.ShelfIndex].FreeX.Add(Slot.X);
+	--Page.NumSlots;
+	
+	// An empty page is repacked from scratch, so its shelves can take a different mix of sizes
+	if (Page.NumSlots <= 0)
+	{
+		Page.Shelves.Empty();
+		Page.NextShelfY = 0;
+		Page.NumSlots = 0;
+	}
+}
+
+void FMaterialVaultThumbnailAtlas::FlushPendingReleases()
+{
+	// Only the atlas holds these brushes now, nothing on screen still samples their region
+	for (int32 Index = PendingReleases.Num() - 1; Index >= 0; --Index)
+	{
+		if (PendingReleases[Index].Brush.IsUnique())
+		{
+			FreeSlot(PendingReleases[Index].Slot);
+			PendingReleases.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+}
+
+UTexture2D* FMaterialVaultThumbnailAtlas::CreatePageTexture() const
+{
+	UTexture2D* Texture = UTexture2D::CreateTransient(MaterialVaultAtlasPageSize, MaterialVaultAtlasPageSize, PF_B8G8R8A8, TEXT("MaterialVaultThumbnailAtlas"));
+	if (!Texture)
+	{
+		return nullptr;
+	}
+	
+	Texture->SRGB = true;
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->NeverStream = true;
+	Texture->LODGroup = TEXTUREGROUP_UI;
+	Texture->UpdateResource();
+	return Texture;
+}
+
+void FMaterialVaultThumbnailAtlas::UploadSlot(UTexture2D* Texture, int32 SlotX, int32 SlotY, const FMaterialVaultThumbnailImage& Image) const
+{
+	// The thumbnail plus its padding, with edge pixels repeated outwards
+	int32 RegionWidth = Image.Width + MaterialVaultAtlasPadding * 2;
+	int32 RegionHeight = Image.Height + MaterialVaultAtlasPadding * 2;
+	uint8* RegionPixels = new uint8[RegionWidth * RegionHeight * 4];
+	
+	for (int32 Y = 0; Y < RegionHeight; ++Y)
+	{
+		int32 SourceY = FMath::Clamp(Y - MaterialVaultAtlasPadding, 0, Image.Height - 1);
+		const uint8* SourceRow = Image.Pixels.GetData() + SourceY * Image.Width * 4;
+		uint8* DestRow = RegionPixels + Y * RegionWidth * 4;
+		
+		FMemory::Memcpy(DestRow + MaterialVaultAtlasPadding * 4, SourceRow, Image.Width * 4);
+		for (int32 Pad = 0; Pad < MaterialVaultAtlasPadding; ++Pad)
+		{
+			FMemory::Memcpy(DestRow + Pad * 4, SourceRow, 4);
+			FMemory::Memcpy(DestRow + (RegionWidth - 1 - Pad) * 4, SourceRow + (Image.Width - 1) * 4, 4);
+		}
+	}
+	
+	// Both buffers are freed by the render thread once the copy has been made
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(SlotX, SlotY, 0, 0, RegionWidth, RegionHeight);
+	Texture->UpdateTextureRegions(0, 1, Region, RegionWidth * 4, 4, RegionPixels, [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+	{
+		delete[] SrcData;
+		delete Regions;
+	});
+}
@@ -0,0 +1,320 @@
+#include "MaterialVaultThumbnailDiskCache.h"
+#include "MaterialVaultThumbnailManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+
+static const uint32 MaterialVaultThumbnailPackMagic = 0x4854564D; // "MVTH"
+static const int32 MaterialVaultThumbnailPackVersion = 1;
+
+FMaterialVaultThumbnailDiskCache::FMaterialVaultThumbnailDiskCache()
+	: Log(GetPackFilePath(), MaterialVaultThumbnailPackMagic, MaterialVaultThumbnailPackVersion)
+	, bLoaded(false)
+{
+}
+
+void FMaterialVaultThumbnailDiskCache::Shutdown()
+{
+	FScopeLock PackScopeLock(&PackLock);
+	if (!bLoaded)
+	{
+		return;
+	}
+	
+	bool bHasGarbage = false;
+	{
+		FScopeLock Lock(&RecordsLock);
+		bHasGarbage = Log.GetNumRecords() > Records.Num();
+	}
+	if (bHasGarbage)
+	{
+		Compact();
+	}
+	
+	{
+		FScopeLock Lock(&RecordsLock);
+		Records.Empty();
+	}
+	bLoaded = false;
+}
+
+bool FMaterialVaultThumbnailDiskCache::Find(FName ObjectPath, const FIoHash& PackageSavedHash, FMaterialVaultThumbnailImage& OutImage)
+{
+	EnsureLoaded();
+	
+	// Only the read is serialized against a compaction swapping the pack, workers read and decode in parallel
+	FRecord Record;
+	TArray<uint8> CompressedPixels;
+	bool bRead = Log.Read([this, ObjectPath, &PackageSavedHash, &Record](int64& OutOffset, int64& OutSize)
+	{
+		FScopeLock Lock(&RecordsLock);
+		
+		FRecord* FoundRecord = Records.Find(ObjectPath);
+		if (!FoundRecord)
+		{
+			return false;
+		}
+		
+		// The package was saved since this thumbnail was cached, the caller extracts and stores a fresh one
+		if (FoundRecord->PackageSavedHash != PackageSavedHash)
+		{
+			Records.Remove(ObjectPath);
+			return false;
+		}
+		
+		Record = *FoundRecord;
+		OutOffset = Record.PixelsOffset;
+		OutSize = Record.CompressedSize;
+		return true;
+	}, CompressedPixels);
+	
+	if (!bRead || Record.Width <= 0 || Record.Height <= 0 || Record.UncompressedSize != Record.Width * Record.Height * 4)
+	{
+		return false;
+	}
+	
+	OutImage.Width = Record.Width;
+	OutImage.Height = Record.Height;
+	OutImage.Pixels.SetNumUninitialized(Record.UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Oodle, OutImage.Pixels.GetData(), Record.UncompressedSize, CompressedPixels.GetData(), CompressedPixels.Num()))
+	{
+		OutImage.Pixels.Empty();
+		return false;
+	}
+	return true;
+}
+
+void FMaterialVaultThumbnailDiskCache::Put(FName ObjectPath, const FIoHash& PackageSavedHash, const FMaterialVaultThumbnailImage& Image)
+{
+	FRecord Record;
+	Record.PackageSavedHash = PackageSavedHash;
+	Record.Width = Image.Width;
+	Record.Height = Image.Height;
+	Record.UncompressedSize = Image.Pixels.Num();
+	
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Record.UncompressedSize);
+	TArray<uint8> CompressedPixels;
+	CompressedPixels.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Oodle, CompressedPixels.GetData(), CompressedSize, Image.Pixels.GetData(), Record.UncompressedSize))
+	{
+		return;
+	}
+	CompressedPixels.SetNum(CompressedSize);
+	Record.CompressedSize = CompressedSize;
+	
+	// Serialize before taking any lock, workers only wait on each other for the file write itself
+	TArray<uint8> Payload;
+	FString RecordPath = ObjectPath.ToString();
+	int64 PixelsPayloadOffset = MakeRecordPayload(RecordPath, Record, CompressedPixels, Payload);
+	
+	EnsureLoaded();
+	
+	FScopeLock PackScopeLock(&PackLock);
+	int64 PayloadOffset = 0;
+	bool bAppended = Log.Append(Payload, &PayloadOffset);
+	if (!bAppended)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MaterialVault: Failed to append thumbnail for %s, rewriting cache"), *RecordPath);
+	}
+	
+	bool bNeedsCompact = !bAppended;
+	{
+		FScopeLock Lock(&RecordsLock);
+		if (bAppended)
+		{
+			Record.PixelsOffset = PayloadOffset + PixelsPayloadOffset;
+			Records.Add(ObjectPath, Record);
+		}
+		else
+		{
+			// Whatever was cached before is for an older save, the next request extracts the thumbnail again
+			Records.Remove(ObjectPath);
+		}
+		bNeedsCompact |= Log.NeedsCompaction(Records.Num());
+	}
+	
+	if (bNeedsCompact)
+	{
+		Compact();
+	}
+}
+
+void FMaterialVaultThumbnailDiskCache::Compact()
+{
+	FScopeLock PackScopeLock(&PackLock);
+	
+	// Copy the index out, lookups carry on against the current pack while the new one is written
+	TArray<TPair<FName, FRecord>> RecordsSnapshot;
+	{
+		FScopeLock Lock(&RecordsLock);
+		RecordsSnapshot = Records.Array();
+	}
+	
+	// Pixels are copied across one record at a time, so compaction never holds the whole pack in memory
+	TArray<int64> PixelsPayloadOffsets;
+	PixelsPayloadOffsets.Init(INDEX_NONE, RecordsSnapshot.Num());
+	TArray<uint8> CompressedPixels;
+	Log.Rewrite(RecordsSnapshot.Num(), [this, &RecordsSnapshot, &PixelsPayloadOffsets, &CompressedPixels](int32 RecordIndex, TArray<uint8>& OutPayload)
+	{
+		const FRecord& Record = RecordsSnapshot[RecordIndex].Value;
+		bool bRead = Log.Read([&Record](int64& OutOffset, int64& OutSize)
+		{
+			OutOffset = Record.PixelsOffset;
+			OutSize = Record.CompressedSize;
+			return true;
+		}, CompressedPixels);
+		if (!bRead)
+		{
+			return false;
+		}
+	
+		PixelsPayloadOffsets[RecordIndex] = MakeRecordPayload(RecordsSnapshot[RecordIndex].Key.ToString(), Record, CompressedPixels, OutPayload);
+		return true;
+	},
+	[this, &RecordsSnapshot, &PixelsPayloadOffsets](const TArray<int64>& PayloadOffsets)
+	{
+		// Appends wait on PackLock, so the only change since the snapshot is lookups dropping stale records
+		FScopeLock Lock(&RecordsLock);
+		for (int32 RecordIndex = 0; RecordIndex < RecordsSnapshot.Num(); ++RecordIndex)
+		{
+			const FName& ObjectPath = RecordsSnapshot[RecordIndex].Key;
+			FRecord* FoundRecord = Records.Find(ObjectPath);
+			if (!FoundRecord || FoundRecord->PixelsOffset != RecordsSnapshot[RecordIndex].Value.PixelsOffset)
+			{
+				continue;
+			}
+	
+			if (PayloadOffsets[RecordIndex] == INDEX_NONE)
+			{
+				Records.Remove(ObjectPath);
+			}
+			else
+			{
+				FoundRecord->PixelsOffset = PayloadOffsets[RecordIndex] + PixelsPayloadOffsets[RecordIndex];
+			}
+		}
+	});
+}
+
+int32 FMaterialVaultThumbnailDiskCache::Num() const
+{
+	FScopeLock Lock(&RecordsLock);
+	return Records.Num();
+}
+
+void FMaterialVaultThumbnailDiskCache::Prune(TFunctionRef<bool(FName ObjectPath)> IsLive)
+{
+	// Nothing was read from the pack this session, so nothing was added to it either
+	if (!bLoaded)
+	{
+		return;
+	}
+	
+	TArray<FName> ObjectPaths;
+	{
+		FScopeLock Lock(&RecordsLock);
+		Records.GetKeys(ObjectPaths);
+	}
+	
+	// Ask about each path outside the lock, the check may query the asset registry
+	TArray<FName> DeadPaths;
+	for (const FName& ObjectPath : ObjectPaths)
+	{
+		if (!IsLive(ObjectPath))
+		{
+			DeadPaths.Add(ObjectPath);
+		}
+	}
+	
+	if (DeadPaths.Num() > 0)
+	{
+		FScopeLock Lock(&RecordsLock);
+		for (const FName& ObjectPath : DeadPaths)
+		{
+			Records.Remove(ObjectPath);
+		}
+		UE_LOG(LogTemp, Log, TEXT("MaterialVault: Dropped %d cached thumbnails of deleted assets"), DeadPaths.Num());
+	}
+}
+
+void FMaterialVaultThumbnailDiskCache::EnsureLoaded()
+{
+	if (bLoaded)
+	{
+		return;
+	}
+	
+	// Lookups wait for the index rather than miss; RecordsLock stays free so nothing compacts while holding it
+	FScopeLock PackScopeLock(&PackLock);
+	if (bLoaded)
+	{
+		return;
+	}
+	
+	TMap<FName, FRecord> LoadedRecords;
+	bool bTruncated = false;
+	bool bHasPack = LoadPack(LoadedRecords, bTruncated);
+	{
+		FScopeLock Lock(&RecordsLock);
+		Records = MoveTemp(LoadedRecords);
+	}
+	
+	// No usable pack yet, start a fresh one; a torn one is rewritten so new appends follow valid data
+	if (!bHasPack || bTruncated)
+	{
+		Compact();
+	}
+	bLoaded = true;
+}
+
+bool FMaterialVaultThumbnailDiskCache::LoadPack(TMap<FName, FRecord>& OutRecords, bool& bOutTruncated)
+{
+	// Only where each thumbnail's pixels are is kept, so cold starts read record headers and skip the pixels
+	return Log.Load([&OutRecords](FArchive& Reader)
+	{
+		FString ObjectPath;
+		FRecord Record;
+		SerializeRecordHeader(Reader, ObjectPath, Record);
+		if (Reader.IsError() || Record.CompressedSize < 0)
+		{
+			return false;
+		}
+		
+		Record.PixelsOffset = Reader.Tell();
+		Reader.Seek(Record.PixelsOffset + Record.CompressedSize);
+		
+		// Later records supersede earlier ones for the same material
+		OutRecords.Add(FName(*ObjectPath), Record);
+		return true;
+	}, bOutTruncated);
+}
+
+void FMaterialVaultThumbnailDiskCache::SerializeRecordHeader(FArchive& Ar, FString& ObjectPath, FRecord& Record)
+{
+	// The compressed size is the element count of the pixel array that follows, as TArray<uint8> serializes it
+	Ar << ObjectPath;
+	Ar << Record.PackageSavedHash;
+	Ar << Record.Width;
+	Ar << Record.Height;
+	Ar << Record.UncompressedSize;
+	Ar << Record.CompressedSize;
+}
+	
+int64 FMaterialVaultThumbnailDiskCache::MakeRecordPayload(const FString& ObjectPath, const FRecord& Record, const TArray<uint8>& CompressedPixels, TArray<uint8>& OutPayload)
+{
+	FMemoryWriter PayloadWriter(OutPayload);
+	FString RecordPath = ObjectPath;
+	FRecord RecordHeader = Record;
+	RecordHeader.CompressedSize = CompressedPixels.Num();
+	SerializeRecordHeader(PayloadWriter, RecordPath, RecordHeader);
+	
+	int64 PixelsPayloadOffset = PayloadWriter.Tell();
+	PayloadWriter.Serialize(const_cast<uint8*>(CompressedPixels.GetData()), CompressedPixels.Num());
+	return PixelsPayloadOffset;
+}
+
+FString FMaterialVaultThumbnailDiskCache::GetPackFilePath()
+{
+	return FPaths::Combine(FPaths::ProjectDir(), TEXT("Saved"), TEXT("MaterialVault"), TEXT("Thumbnails"), TEXT("Thumbnails.bin"));
+}
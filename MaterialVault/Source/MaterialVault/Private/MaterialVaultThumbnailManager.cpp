@@ -1,4 +1,6 @@
 #include "MaterialVaultThumbnailManager.h"
+#include "MaterialVaultThumbnailDiskCache.h"
+#include "MaterialVaultThumbnailAtlas.h"
 #include "Materials/MaterialInterface.h"
 #include "Engine/Texture2D.h"
 #include "Engine/TextureRenderTarget2D.h"
@@ -13,12 +15,37 @@
 #include "Slate/SlateTextures.h"
 #include "TextureResource.h"
 #include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/ObjectThumbnail.h"
+#include "Misc/PackageName.h"
+#include "ObjectTools.h"
+
+// Requests waiting for a load slot; beyond this the oldest are dropped, they are the least likely to still be on screen
+static const int32 MaterialVaultMaxQueuedThumbnails = 512;
+
+// Decoded pixels kept in memory by default, roughly 750 thumbnails at 256px with their downsampled levels
+static const int64 MaterialVaultDefaultThumbnailBudget = 256 * 1024 * 1024;
+
+// Smallest downsampled level kept per thumbnail, the grid never shows tiles below this
+static const int32 MaterialVaultMinThumbnailMipSize = 32;
 
 FMaterialVaultThumbnailManager::FMaterialVaultThumbnailManager()
-	: DefaultThumbnailSize(128)
-	, MaxCacheSize(1000)
+	: LruHead(nullptr)
+	, LruTail(nullptr)
+	, CacheBytesUsed(0)
+	, DefaultThumbnailSize(128)
+	, CacheByteBudget(MaterialVaultDefaultThumbnailBudget)
+	, CacheHits(0)
+	, CacheMisses(0)
+	, CacheEvictions(0)
+	, JoinedRequests(0)
+	, NextRequestId(0)
+	, NumActiveLoads(0)
+	, MaxActiveLoads(2)
+	, MaxQueuedRequests(MaterialVaultMaxQueuedThumbnails)
 	, DefaultMaterialTexture(nullptr)
 	, ErrorTexture(nullptr)
+	, NextBrushId(0)
 	, bIsInitialized(false)
 {
 }
@@ -42,6 +69,12 @@ void FMaterialVaultThumbnailManager::Initialize()
 	DefaultMaterialTexture = LoadObject<UTexture2D>(nullptr, TEXT("/Engine/EditorMaterials/DefaultMaterial"));
 	ErrorTexture = LoadObject<UTexture2D>(nullptr, TEXT("/Engine/EditorMaterials/DefaultDiffuse"));
 	
+	// Keep one extraction in flight per worker so thumbnail throughput follows the core count
+	MaxActiveLoads = FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads(), 2, 16);
+	
+	DiskCache = MakeShared<FMaterialVaultThumbnailDiskCache>();
+	Atlas = MakeShared<FMaterialVaultThumbnailAtlas>();
+	
 	bIsInitialized = true;
 }
 
@@ -52,9 +85,28 @@ void FMaterialVaultThumbnailManager::Shutdown()
 		return;
 	}
 	
+	// Workers still running skip their read and release their load slot when they finish
+	for (auto& RequestPair : Requests)
+	{
+		if (RequestPair.Value.CancelFlag.IsValid())
+		{
+			*RequestPair.Value.CancelFlag = true;
+		}
+	}
+	Requests.Empty();
+	QueuedRequestKeys.Empty();
+	QueuedPriorityKeys.Empty();
+	RequestKeysById.Empty();
+	
 	// Clear cache
 	ClearThumbnailCache();
-	PendingThumbnails.Empty();
+	
+	if (DiskCache.IsValid())
+	{
+		DiskCache->Shutdown();
+		DiskCache.Reset();
+	}
+	Atlas.Reset();
 	
 	DefaultMaterialTexture = nullptr;
 	ErrorTexture = nullptr;
@@ -69,76 +121,184 @@ TSharedPtr<FSlateBrush> FMaterialVaultThumbnailManager::GetMaterialThumbnail(TSh
 		return nullptr;
 	}
 	
-	FString CacheKey = GetCacheKey(MaterialItem->AssetData.GetObjectPathString(), ThumbnailSize);
-	
-	// Check cache first
-	if (ThumbnailCache.Contains(CacheKey))
+	// Check cache first, any size is served from the level closest to it
+	FName CacheKey = MakeCacheKey(MaterialItem->AssetData);
+	if (FThumbnailCacheEntry* Entry = FindCacheEntry(CacheKey))
 	{
-		FThumbnailCacheEntry& Entry = ThumbnailCache[CacheKey];
-		Entry.LastAccessTime = FDateTime::Now();
-		return Entry.Brush;
+		return SelectMipBrush(Entry->MipBrushes, ThumbnailSize);
 	}
 	
 	// Generate thumbnail if not cached
-	RequestThumbnail(MaterialItem, ThumbnailSize);
+	QueueRequest(MaterialItem->AssetData, MaterialItem->PackageSavedHash, CacheKey, false);
+	PumpRequests();
 	
-	// Return default thumbnail while generating
-	if (DefaultMaterialTexture)
+	// Return default thumbnail while extracting
+	return CreateBrushFromTexture(GetDefaultMaterialThumbnail(), ThumbnailSize);
+}
+
+int32 FMaterialVaultThumbnailManager::RequestThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bHighPriority)
+{
+	if (!MaterialItem.IsValid())
 	{
-		return CreateBrushFromTexture(DefaultMaterialTexture, ThumbnailSize);
+		return INDEX_NONE;
 	}
 	
-	return nullptr;
+	return RequestThumbnail(MaterialItem->AssetData, MaterialItem->PackageSavedHash, ThumbnailSize, MoveTemp(OnThumbnailReady), bHighPriority);
 }
 
-void FMaterialVaultThumbnailManager::RequestThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize)
+int32 FMaterialVaultThumbnailManager::RequestThumbnail(const FAssetData& AssetData, const FIoHash& PackageSavedHash, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bHighPriority)
 {
-	if (!MaterialItem.IsValid() || !bIsInitialized)
+	if (!AssetData.IsValid() || !bIsInitialized)
 	{
+		return INDEX_NONE;
+	}
+	
+	FName CacheKey = MakeCacheKey(AssetData);
+	
+	// Already cached, deliver right away
+	if (FThumbnailCacheEntry* Entry = FindCacheEntry(CacheKey))
+	{
+		OnThumbnailReady.ExecuteIfBound(SelectMipBrush(Entry->MipBrushes, ThumbnailSize), false);
+		return INDEX_NONE;
+	}
+	
+	QueueRequest(AssetData, PackageSavedHash, CacheKey, bHighPriority);
+	
+	int32 RequestId = INDEX_NONE;
+	if (OnThumbnailReady.IsBound())
+	{
+		RequestId = NextRequestId++;
+		FThumbnailListener& Listener = Requests.FindChecked(CacheKey).Listeners.AddDefaulted_GetRef();
+		Listener.RequestId = RequestId;
+		Listener.ThumbnailSize = ThumbnailSize;
+		Listener.OnThumbnailReady = MoveTemp(OnThumbnailReady);
+		RequestKeysById.Add(RequestId, CacheKey);
+	}
+	
+	PumpRequests();
+	return RequestId;
+}
+
+void FMaterialVaultThumbnailManager::QueueRequest(const FAssetData& AssetData, const FIoHash& PackageSavedHash, FName CacheKey, bool bHighPriority)
+{
+	// Join a request already queued or loading for the same asset, whatever view or size it was made for
+	if (FThumbnailRequest* ExistingRequest = Requests.Find(CacheKey))
+	{
+		++JoinedRequests;
+		
+		// A prefetched thumbnail that came on screen moves ahead of the other waiting requests
+		if (bHighPriority && !ExistingRequest->bHighPriority && !ExistingRequest->bLoading)
+		{
+			ExistingRequest->bHighPriority = true;
+			QueuedRequestKeys.Remove(CacheKey);
+			QueuedPriorityKeys.Add(CacheKey);
+		}
 		return;
 	}
 	
-	FString MaterialPath = MaterialItem->AssetData.GetObjectPathString();
+	// Bound the queue by dropping the oldest waiting requests, prefetches before on-screen ones; their callers are told so they can ask again
+	while (QueuedRequestKeys.Num() + QueuedPriorityKeys.Num() >= MaxQueuedRequests)
+	{
+		TArray<FName>& DropQueue = QueuedRequestKeys.Num() > 0 ? QueuedRequestKeys : QueuedPriorityKeys;
+		FName DroppedKey = DropQueue[0];
+		DropQueue.RemoveAt(0, EAllowShrinking::No);
+		FinishRequest(DroppedKey, TArray<TSharedPtr<FSlateBrush>>(), true);
+	}
+	
+	FThumbnailRequest& Request = Requests.Add(CacheKey);
+	FPackageName::TryConvertLongPackageNameToFilename(AssetData.PackageName.ToString(), Request.PackageFileName, FPackageName::GetAssetPackageExtension());
+	Request.ObjectFullName = FName(*AssetData.GetFullName());
+	Request.PackageSavedHash = PackageSavedHash;
+	Request.bHighPriority = bHighPriority;
+	(bHighPriority ? QueuedPriorityKeys : QueuedRequestKeys).Add(CacheKey);
+}
+
+void FMaterialVaultThumbnailManager::CancelThumbnailRequest(int32 RequestId)
+{
+	FName RequestKey;
+	if (!RequestKeysById.RemoveAndCopyValue(RequestId, RequestKey))
+	{
+		return;
+	}
 	
-	// Check if already pending
-	if (PendingThumbnails.Contains(MaterialPath))
+	FThumbnailRequest* Request = Requests.Find(RequestKey);
+	if (!Request)
 	{
 		return;
 	}
 	
-	// Add to pending list
-	PendingThumbnails.Add(MaterialPath, MaterialItem);
+	Request->Listeners.RemoveAll([RequestId](const FThumbnailListener& Listener)
+	{
+		return Listener.RequestId == RequestId;
+	});
 	
-	// Generate thumbnail asynchronously
-	LoadThumbnailAsync(MaterialItem, ThumbnailSize);
+	// Other callers still want this thumbnail
+	if (Request->Listeners.Num() == 0)
+	{
+		CancelRequest(RequestKey);
+	}
 }
 
 void FMaterialVaultThumbnailManager::ClearThumbnailCache()
 {
+	for (const auto& CachePair : ThumbnailCache)
+	{
+		ReleaseAtlasSlots(*CachePair.Value);
+	}
 	ThumbnailCache.Empty();
+	LruHead = nullptr;
+	LruTail = nullptr;
+	CacheBytesUsed = 0;
 }
 
 void FMaterialVaultThumbnailManager::ClearThumbnailForMaterial(const FString& MaterialPath)
 {
-	for (auto It = ThumbnailCache.CreateIterator(); It; ++It)
+	RemoveCacheEntry(FName(*MaterialPath));
+}
+
+void FMaterialVaultThumbnailManager::PruneDiskCache(TFunctionRef<bool(FName ObjectPath)> IsLive)
+{
+	if (DiskCache.IsValid())
 	{
-		if (It.Key().Contains(MaterialPath))
-		{
-			It.RemoveCurrent();
-		}
+		DiskCache->Prune(IsLive);
 	}
 }
 
-UTexture2D* FMaterialVaultThumbnailManager::GenerateMaterialThumbnail(UMaterialInterface* Material, int32 ThumbnailSize)
+bool FMaterialVaultThumbnailManager::ExtractPackageThumbnail(const FString& PackageFileName, FName ObjectFullName, FMaterialVaultThumbnailImage& OutImage)
 {
-	if (!Material || !bIsInitialized)
+	if (PackageFileName.IsEmpty())
+	{
+		return false;
+	}
+	
+	// Reads only the thumbnail table saved with the package, the material itself is never loaded
+	TSet<FName> ObjectFullNames;
+	ObjectFullNames.Add(ObjectFullName);
+	FThumbnailMap Thumbnails;
+	if (!ThumbnailTools::LoadThumbnailsFromPackage(PackageFileName, ObjectFullNames, Thumbnails))
+	{
+		return false;
+	}
+	
+	FObjectThumbnail* Thumbnail = Thumbnails.Find(ObjectFullName);
+	if (!Thumbnail || Thumbnail->IsEmpty())
+	{
+		return false;
+	}
+	
+	// Stored compressed, decoding happens here on the worker
+	const TArray<uint8>& ImageData = Thumbnail->GetUncompressedImageData();
+	int32 Width = Thumbnail->GetImageWidth();
+	int32 Height = Thumbnail->GetImageHeight();
+	if (Width <= 0 || Height <= 0 || ImageData.Num() != Width * Height * 4)
 	{
-		return GetDefaultMaterialThumbnail();
+		return false;
 	}
 	
-	// For now, return a default thumbnail
-	// In a full implementation, this would render the material to a texture
-	return GetDefaultMaterialThumbnail();
+	OutImage.Width = Width;
+	OutImage.Height = Height;
+	OutImage.Pixels = ImageData;
+	return true;
 }
 
 TSharedPtr<FSlateDynamicImageBrush> FMaterialVaultThumbnailManager::CreateBrushFromTexture(UTexture2D* Texture, int32 ThumbnailSize)
@@ -155,95 +315,387 @@ TSharedPtr<FSlateDynamicImageBrush> FMaterialVaultThumbnailManager::CreateBrushF
 	));
 }
 
-void FMaterialVaultThumbnailManager::LoadThumbnailAsync(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize)
+TSharedPtr<FSlateDynamicImageBrush> FMaterialVaultThumbnailManager::CreateBrushFromImage(const FMaterialVaultThumbnailImage& Image)
 {
-	if (!MaterialItem.IsValid())
+	FName ResourceName(*FString::Printf(TEXT("MaterialVaultThumbnail_%d"), NextBrushId++));
+	return FSlateDynamicImageBrush::CreateWithImageData(ResourceName, FVector2D(Image.Width, Image.Height), Image.Pixels);
+}
+
+void FMaterialVaultThumbnailManager::DownsampleThumbnail(const FMaterialVaultThumbnailImage& Source, FMaterialVaultThumbnailImage& OutImage)
+{
+	OutImage.Width = FMath::Max(Source.Width / 2, 1);
+	OutImage.Height = FMath::Max(Source.Height / 2, 1);
+	OutImage.Pixels.SetNumUninitialized(OutImage.Width * OutImage.Height * 4);
+	
+	// 2x2 box filter, one BGRA pixel per vector; odd edges reuse the last row or column
+	const VectorRegister4Float Quarter = VectorSetFloat1(0.25f);
+	const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+	const uint8* SourcePixels = Source.Pixels.GetData();
+	uint8* DestPixels = OutImage.Pixels.GetData();
+	
+	for (int32 Y = 0; Y < OutImage.Height; ++Y)
+	{
+		const uint8* Row0 = SourcePixels + (Y * 2) * Source.Width * 4;
+		const uint8* Row1 = SourcePixels + FMath::Min(Y * 2 + 1, Source.Height - 1) * Source.Width * 4;
+		uint8* DestRow = DestPixels + Y * OutImage.Width * 4;
+		
+		for (int32 X = 0; X < OutImage.Width; ++X)
+		{
+			int32 X0 = X * 2 * 4;
+			int32 X1 = FMath::Min(X * 2 + 1, Source.Width - 1) * 4;
+			
+			VectorRegister4Float Sum = VectorAdd(VectorLoadByte4(Row0 + X0), VectorLoadByte4(Row0 + X1));
+			Sum = VectorAdd(Sum, VectorAdd(VectorLoadByte4(Row1 + X0), VectorLoadByte4(Row1 + X1)));
+			
+			// Rounded rather than truncated so repeated halving does not darken the image
+			VectorStoreByte4(VectorMultiplyAdd(Sum, Quarter, Half), DestRow + X * 4);
+		}
+	}
+}
+
+void FMaterialVaultThumbnailManager::BuildThumbnailMips(FMaterialVaultThumbnailImage&& Source, TArray<FMaterialVaultThumbnailImage>& OutMips)
+{
+	OutMips.Reset();
+	OutMips.Add(MoveTemp(Source));
+	
+	while (FMath::Max(OutMips.Last().Width, OutMips.Last().Height) >= MaterialVaultMinThumbnailMipSize * 2)
+	{
+		FMaterialVaultThumbnailImage Mip;
+		DownsampleThumbnail(OutMips.Last(), Mip);
+		OutMips.Add(MoveTemp(Mip));
+	}
+}
+
+TSharedPtr<FSlateBrush> FMaterialVaultThumbnailManager::SelectMipBrush(const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, int32 ThumbnailSize)
+{
+	// Smallest level that still covers the requested size, so tiles are only ever scaled down
+	for (int32 MipIndex = MipBrushes.Num() - 1; MipIndex > 0; --MipIndex)
+	{
+		if (MipBrushes[MipIndex]->ImageSize.X >= ThumbnailSize)
+		{
+			return MipBrushes[MipIndex];
+		}
+	}
+	return MipBrushes.Num() > 0 ? MipBrushes[0] : nullptr;
+}
+
+void FMaterialVaultThumbnailManager::PumpRequests()
+{
+	while (NumActiveLoads < MaxActiveLoads && QueuedRequestKeys.Num() + QueuedPriorityKeys.Num() > 0)
+	{
+		TArray<FName>& Queue = QueuedPriorityKeys.Num() > 0 ? QueuedPriorityKeys : QueuedRequestKeys;
+		FName RequestKey = Queue[0];
+		Queue.RemoveAt(0, EAllowShrinking::No);
+		StartLoad(RequestKey);
+	}
+}
+
+void FMaterialVaultThumbnailManager::StartLoad(FName RequestKey)
+{
+	FThumbnailRequest* Request = Requests.Find(RequestKey);
+	if (!Request)
 	{
 		return;
 	}
 	
-	FString MaterialPath = MaterialItem->AssetData.GetObjectPathString();
+	Request->bLoading = true;
+	Request->CancelFlag = MakeShared<FThreadSafeBool>(false);
+	++NumActiveLoads;
 	
-	// Load material asynchronously
-	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, MaterialItem, ThumbnailSize, MaterialPath]()
+	// Completion runs on the game thread and is dropped if the manager has been destroyed
+	TWeakPtr<FMaterialVaultThumbnailManager> WeakThis = AsShared();
+	Async(EAsyncExecution::ThreadPool, [WeakThis, RequestKey, PackageFileName = Request->PackageFileName, ObjectFullName = Request->ObjectFullName, PackageSavedHash = Request->PackageSavedHash, CancelFlag = Request->CancelFlag, DiskCache = DiskCache]()
 	{
-		UMaterialInterface* Material = MaterialItem->MaterialPtr.LoadSynchronous();
-		if (Material)
+		FMaterialVaultThumbnailImage Image;
+		TSharedPtr<TArray<FMaterialVaultThumbnailImage>> Mips;
+		
+		// Disk cache first, then the package; items without a known hash cannot be validated and skip the disk cache
+		bool bUseDiskCache = DiskCache.IsValid() && !PackageSavedHash.IsZero();
+		bool bFound = false;
+		if (!*CancelFlag)
 		{
-			UTexture2D* Thumbnail = GenerateMaterialThumbnail(Material, ThumbnailSize);
-			if (Thumbnail)
+			bFound = bUseDiskCache && DiskCache->Find(RequestKey, PackageSavedHash, Image);
+			if (!bFound && ExtractPackageThumbnail(PackageFileName, ObjectFullName, Image))
 			{
-				// Switch back to game thread to update UI
-				AsyncTask(ENamedThreads::GameThread, [this, MaterialPath, Thumbnail, ThumbnailSize]()
+				bFound = true;
+				if (bUseDiskCache)
 				{
-					OnThumbnailGenerated(MaterialPath, Thumbnail, ThumbnailSize);
-				});
+					DiskCache->Put(RequestKey, PackageSavedHash, Image);
+				}
 			}
 		}
 		
-		// Remove from pending list
-		PendingThumbnails.Remove(MaterialPath);
+		// Every display size is derived here once, the size slider then only picks a level
+		if (bFound && !*CancelFlag)
+		{
+			Mips = MakeShared<TArray<FMaterialVaultThumbnailImage>>();
+			BuildThumbnailMips(MoveTemp(Image), *Mips);
+		}
+		
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, RequestKey, Mips, CancelFlag]()
+		{
+			TSharedPtr<FMaterialVaultThumbnailManager> ThumbnailManager = WeakThis.Pin();
+			if (!ThumbnailManager.IsValid())
+			{
+				return;
+			}
+			
+			// A cancelled request may have been made again under the same key, leave that one to its own worker
+			if (*CancelFlag)
+			{
+				ThumbnailManager->OnCancelledLoadFinished();
+			}
+			else
+			{
+				ThumbnailManager->OnThumbnailExtracted(RequestKey, Mips);
+			}
+		});
 	});
 }
 
-void FMaterialVaultThumbnailManager::SetThumbnailSize(int32 NewSize)
+void FMaterialVaultThumbnailManager::OnThumbnailExtracted(FName RequestKey, TSharedPtr<TArray<FMaterialVaultThumbnailImage>> Mips)
 {
-	DefaultThumbnailSize = FMath::Clamp(NewSize, 32, 512);
+	if (!Requests.Contains(RequestKey))
+	{
+		return;
+	}
+	
+	// Packages saved without a thumbnail keep the default one
+	TArray<TSharedPtr<FSlateBrush>> MipBrushes;
+	TArray<FMaterialVaultAtlasSlot> MipSlots;
+	int64 SizeBytes = 0;
+	if (Mips.IsValid())
+	{
+		for (const FMaterialVaultThumbnailImage& Mip : *Mips)
+		{
+			// Packed into a shared atlas page, a thumbnail too large for a page gets its own texture
+			FMaterialVaultAtlasSlot Slot;
+			TSharedPtr<FSlateBrush> Brush = Atlas.IsValid() ? Atlas->Add(Mip, Slot) : nullptr;
+			if (!Brush.IsValid())
+			{
+				Brush = CreateBrushFromImage(Mip);
+			}
+			if (!Brush.IsValid())
+			{
+				break;
+			}
+			MipBrushes.Add(Brush);
+			MipSlots.Add(Slot);
+			SizeBytes += Mip.Pixels.Num();
+		}
+	}
+	
+	if (MipBrushes.Num() > 0)
+	{
+		AddCacheEntry(RequestKey, MipBrushes, MipSlots, SizeBytes);
+	}
+	
+	FinishRequest(RequestKey, MipBrushes, false);
+	PumpRequests();
 }
 
-void FMaterialVaultThumbnailManager::TrimCache()
+void FMaterialVaultThumbnailManager::OnCancelledLoadFinished()
+{
+	--NumActiveLoads;
+	PumpRequests();
+}
+
+void FMaterialVaultThumbnailManager::CancelRequest(FName RequestKey)
 {
-	if (ThumbnailCache.Num() <= MaxCacheSize)
+	FThumbnailRequest* Request = Requests.Find(RequestKey);
+	if (!Request)
 	{
 		return;
 	}
 	
-	// Sort by last access time and remove oldest entries
-	TArray<TPair<FString, FDateTime>> SortedEntries;
-	for (const auto& Entry : ThumbnailCache)
+	// A cancelled load keeps its slot until the worker stops, it only checks the flag between steps
+	if (Request->bLoading)
 	{
-		SortedEntries.Add(TPair<FString, FDateTime>(Entry.Key, Entry.Value.LastAccessTime));
+		*Request->CancelFlag = true;
+	}
+	else
+	{
+		(Request->bHighPriority ? QueuedPriorityKeys : QueuedRequestKeys).Remove(RequestKey);
 	}
 	
-	SortedEntries.Sort([](const TPair<FString, FDateTime>& A, const TPair<FString, FDateTime>& B)
+	for (const FThumbnailListener& Listener : Request->Listeners)
 	{
-		return A.Value < B.Value;
-	});
+		RequestKeysById.Remove(Listener.RequestId);
+	}
+	Requests.Remove(RequestKey);
+	
+	PumpRequests();
+}
+
+void FMaterialVaultThumbnailManager::FinishRequest(FName RequestKey, const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, bool bDropped)
+{
+	FThumbnailRequest Request;
+	if (!Requests.RemoveAndCopyValue(RequestKey, Request))
+	{
+		return;
+	}
+	
+	if (Request.bLoading)
+	{
+		--NumActiveLoads;
+	}
+	else
+	{
+		(Request.bHighPriority ? QueuedPriorityKeys : QueuedRequestKeys).Remove(RequestKey);
+	}
 	
-	// Remove oldest entries
-	int32 EntriesToRemove = ThumbnailCache.Num() - MaxCacheSize;
-	for (int32 i = 0; i < EntriesToRemove; ++i)
+	// Listeners may request more thumbnails, the request has already been removed
+	for (FThumbnailListener& Listener : Request.Listeners)
 	{
-		ThumbnailCache.Remove(SortedEntries[i].Key);
+		RequestKeysById.Remove(Listener.RequestId);
+		Listener.OnThumbnailReady.ExecuteIfBound(SelectMipBrush(MipBrushes, Listener.ThumbnailSize), bDropped);
 	}
 }
 
-FString FMaterialVaultThumbnailManager::GetCacheKey(const FString& MaterialPath, int32 ThumbnailSize) const
+void FMaterialVaultThumbnailManager::SetThumbnailSize(int32 NewSize)
 {
-	return FString::Printf(TEXT("%s_%d"), *MaterialPath, ThumbnailSize);
+	DefaultThumbnailSize = FMath::Clamp(NewSize, 32, 512);
 }
 
-void FMaterialVaultThumbnailManager::OnThumbnailGenerated(const FString& MaterialPath, UTexture2D* Thumbnail, int32 ThumbnailSize)
+void FMaterialVaultThumbnailManager::SetCacheByteBudget(int64 NewByteBudget)
 {
-	if (!Thumbnail)
+	CacheByteBudget = FMath::Max<int64>(NewByteBudget, 0);
+	TrimCache();
+}
+
+FMaterialVaultThumbnailCacheStats FMaterialVaultThumbnailManager::GetCacheStats() const
+{
+	FMaterialVaultThumbnailCacheStats Stats;
+	Stats.Hits = CacheHits;
+	Stats.Misses = CacheMisses;
+	Stats.Evictions = CacheEvictions;
+	Stats.JoinedRequests = JoinedRequests;
+	Stats.BytesUsed = CacheBytesUsed;
+	Stats.ByteBudget = CacheByteBudget;
+	Stats.NumEntries = ThumbnailCache.Num();
+	Stats.NumAtlasPages = Atlas.IsValid() ? Atlas->GetNumPages() : 0;
+	Stats.NumPendingRequests = Requests.Num();
+	return Stats;
+}
+
+void FMaterialVaultThumbnailManager::ResetCacheStats()
+{
+	CacheHits = 0;
+	CacheMisses = 0;
+	CacheEvictions = 0;
+	JoinedRequests = 0;
+}
+
+void FMaterialVaultThumbnailManager::TrimCache()
+{
+	// Evict from the cold end until the pixels fit the budget
+	while (CacheBytesUsed > CacheByteBudget && LruTail)
 	{
-		return;
+		RemoveCacheEntry(LruTail->Key);
+		++CacheEvictions;
+	}
+}
+
+FMaterialVaultThumbnailManager::FThumbnailCacheEntry* FMaterialVaultThumbnailManager::FindCacheEntry(FName Key)
+{
+	TUniquePtr<FThumbnailCacheEntry>* Entry = ThumbnailCache.Find(Key);
+	if (!Entry)
+	{
+		++CacheMisses;
+		return nullptr;
 	}
 	
-	FString CacheKey = GetCacheKey(MaterialPath, ThumbnailSize);
-	
-	FThumbnailCacheEntry Entry;
-	Entry.Texture = Thumbnail;
-	Entry.Brush = CreateBrushFromTexture(Thumbnail, ThumbnailSize);
-	Entry.ThumbnailSize = ThumbnailSize;
-	Entry.LastAccessTime = FDateTime::Now();
+	++CacheHits;
+	Unlink(Entry->Get());
+	LinkAtHead(Entry->Get());
+	return Entry->Get();
+}
+
+void FMaterialVaultThumbnailManager::AddCacheEntry(FName Key, const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, const TArray<FMaterialVaultAtlasSlot>& MipSlots, int64 SizeBytes)
+{
+	RemoveCacheEntry(Key);
 	
-	ThumbnailCache.Add(CacheKey, Entry);
+	TUniquePtr<FThumbnailCacheEntry>& Entry = ThumbnailCache.Add(Key, MakeUnique<FThumbnailCacheEntry>());
+	Entry->Key = Key;
+	Entry->MipBrushes = MipBrushes;
+	Entry->MipSlots = MipSlots;
+	Entry->SizeBytes = SizeBytes;
+	LinkAtHead(Entry.Get());
+	CacheBytesUsed += SizeBytes;
 	
-	// Trim cache if needed
 	TrimCache();
 }
 
+void FMaterialVaultThumbnailManager::RemoveCacheEntry(FName Key)
+{
+	TUniquePtr<FThumbnailCacheEntry> Entry;
+	if (ThumbnailCache.RemoveAndCopyValue(Key, Entry))
+	{
+		Unlink(Entry.Get());
+		CacheBytesUsed -= Entry->SizeBytes;
+		ReleaseAtlasSlots(*Entry);
+	}
+}
+
+void FMaterialVaultThumbnailManager::ReleaseAtlasSlots(FThumbnailCacheEntry& Entry)
+{
+	if (!Atlas.IsValid())
+	{
+		return;
+	}
+	
+	for (int32 MipIndex = 0; MipIndex < Entry.MipSlots.Num(); ++MipIndex)
+	{
+		Atlas->Release(Entry.MipSlots[MipIndex], MoveTemp(Entry.MipBrushes[MipIndex]));
+	}
+	Entry.MipSlots.Empty();
+	Entry.MipBrushes.Empty();
+}
+
+void FMaterialVaultThumbnailManager::LinkAtHead(FThumbnailCacheEntry* Entry)
+{
+	Entry->LruPrev = nullptr;
+	Entry->LruNext = LruHead;
+	if (LruHead)
+	{
+		LruHead->LruPrev = Entry;
+	}
+	LruHead = Entry;
+	if (!LruTail)
+	{
+		LruTail = Entry;
+	}
+}
+
+void FMaterialVaultThumbnailManager::Unlink(FThumbnailCacheEntry* Entry)
+{
+	if (Entry->LruPrev)
+	{
+		Entry->LruPrev->LruNext = Entry->LruNext;
+	}
+	else
+	{
+		LruHead = Entry->LruNext;
+	}
+	
+	if (Entry->LruNext)
+	{
+		Entry->LruNext->LruPrev = Entry->LruPrev;
+	}
+	else
+	{
+		LruTail = Entry->LruPrev;
+	}
+	
+	Entry->LruPrev = nullptr;
+	Entry->LruNext = nullptr;
+}
+
+FName FMaterialVaultThumbnailManager::MakeCacheKey(const FAssetData& AssetData)
+{
+	return FName(*AssetData.GetObjectPathString());
+}
+
 UTexture2D* FMaterialVaultThumbnailManager::GetDefaultMaterialThumbnail() const
 {
 	if (DefaultMaterialTexture)
@@ -257,4 +709,4 @@ UTexture2D* FMaterialVaultThumbnailManager::GetDefaultMaterialThumbnail() const
 	}
 	
 	return nullptr;
-} 
\ No newline at end of file
+}
@@ -27,7 +27,7 @@ void SMaterialVaultCategoryTreeItem::Construct(const FArguments& InArgs, const T
 			.Padding(2.0f, 0.0f, 6.0f, 0.0f)
 			[
 				SNew(SImage)
-				.Image(this, &SMaterialVaultCategoryTreeItem::GetCategoryIcon)
+				.Image(GetCategoryIcon())
 				.ColorAndOpacity(FSlateColor::UseForeground())
 			]
 			+ SHorizontalBox::Slot()
@@ -35,7 +35,7 @@ void SMaterialVaultCategoryTreeItem::Construct(const FArguments& InArgs, const T
 			.VAlign(VAlign_Center)
 			[
 							SNew(STextBlock)
-			.Text(this, &SMaterialVaultCategoryTreeItem::GetCategoryName)
+			.Text(GetCategoryName())
 			.Font(FCoreStyle::GetDefaultFontStyle("Regular", 10))
 			]
 			+ SHorizontalBox::Slot()
@@ -44,7 +44,7 @@ void SMaterialVaultCategoryTreeItem::Construct(const FArguments& InArgs, const T
 			.Padding(6.0f, 0.0f, 2.0f, 0.0f)
 			[
 							SNew(STextBlock)
-			.Text(this, &SMaterialVaultCategoryTreeItem::GetMaterialCount)
+			.Text(GetMaterialCount())
 			.Font(FCoreStyle::GetDefaultFontStyle("Regular", 9))
 			.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 			]
@@ -421,8 +421,12 @@ void SMaterialVaultCategoriesPanel::OnDeleteCategory(TSharedPtr<FMaterialVaultCa
 		}
 	}
 	
-	// Refresh the display
+	// Refresh the display, rows show their counts as built so the surviving ones are regenerated
 	ApplyFilter();
+	if (CategoryTreeView.IsValid())
+	{
+		CategoryTreeView->RebuildList();
+	}
 }
 
 void SMaterialVaultCategoriesPanel::ApplyFilter()
@@ -506,46 +510,9 @@ void SMaterialVaultCategoriesPanel::RefreshTags()
 
 	// Clear existing tags
 	AllTags.Empty();
-	TSet<FString> UniqueTagsSet;
 
-	// Get all materials from all folders
-	TSharedPtr<FMaterialVaultFolderNode> RootFolder = MaterialVaultManager->GetRootFolder();
-	if (RootFolder.IsValid())
-	{
-		TFunction<void(TSharedPtr<FMaterialVaultFolderNode>)> CollectTags = [&](TSharedPtr<FMaterialVaultFolderNode> Folder)
-		{
-			if (Folder.IsValid())
-			{
-				for (const auto& Material : Folder->Materials)
-				{
-					if (Material.IsValid())
-					{
-						// Ensure metadata is loaded
-						MaterialVaultManager->LoadMaterialMetadata(Material);
-						
-						// Add all tags from this material
-						for (const FString& TagName : Material->Metadata.Tags)
-						{
-							if (!TagName.IsEmpty())
-							{
-								UniqueTagsSet.Add(TagName);
-							}
-						}
-					}
-				}
-				
-				for (const auto& Child : Folder->Children)
-				{
-					CollectTags(Child);
-				}
-			}
-		};
-		
-		CollectTags(RootFolder);
-	}
-
-	// Convert set to array of shared pointers for tags list
-	for (const FString& TagName : UniqueTagsSet)
+	// Tags come straight from the manager's tag index
+	for (const FString& TagName : MaterialVaultManager->GetAllTags())
 	{
 		AllTags.Add(MakeShareable(new FString(TagName)));
 	}
@@ -568,12 +535,7 @@ void SMaterialVaultCategoriesPanel::RefreshTags()
 TSharedRef<ITableRow> SMaterialVaultCategoriesPanel::OnGenerateTagWidget(TSharedPtr<FString> TagItem, const TSharedRef<STableViewBase>& OwnerTable)
 {
 	// Count materials with this tag
-	int32 MaterialCount = 0;
-	if (MaterialVaultManager)
-	{
-		TArray<TSharedPtr<FMaterialVaultMaterialItem>> TaggedMaterials = MaterialVaultManager->FilterMaterialsByTag(*TagItem);
-		MaterialCount = TaggedMaterials.Num();
-	}
+	int32 MaterialCount = MaterialVaultManager ? MaterialVaultManager->GetMaterialCountForTag(*TagItem) : 0;
 
 	return SNew(STableRow<TSharedPtr<FString>>, OwnerTable)
 		.Padding(FMargin(2.0f, 1.0f))
@@ -675,39 +637,14 @@ void SMaterialVaultCategoriesPanel::OnDeleteTag(TSharedPtr<FString> TagToDelete)
 	FString TagName = *TagToDelete;
 	
 	// Remove the tag from all materials that have it
-	TSharedPtr<FMaterialVaultFolderNode> RootFolder = MaterialVaultManager->GetRootFolder();
-	if (RootFolder.IsValid())
+	for (const TSharedPtr<FMaterialVaultMaterialItem>& Material : MaterialVaultManager->FilterMaterialsByTag(TagName))
 	{
-		TFunction<void(TSharedPtr<FMaterialVaultFolderNode>)> RemoveTagFromMaterials = [&](TSharedPtr<FMaterialVaultFolderNode> Folder)
+		Material->Metadata.Tags.RemoveAll([&TagName](const FString& MaterialTag)
 		{
-			if (Folder.IsValid())
-			{
-				for (const auto& Material : Folder->Materials)
-				{
-					if (Material.IsValid())
-					{
-						// Remove the tag if it exists
-						int32 RemovedCount = Material->Metadata.Tags.RemoveAll([&TagName](const FString& MaterialTag)
-						{
-							return MaterialTag == TagName;
-						});
-						
-						// Save metadata if we removed the tag
-						if (RemovedCount > 0)
-						{
-							MaterialVaultManager->SaveMaterialMetadata(Material);
-						}
-					}
-				}
-				
-				for (const auto& Child : Folder->Children)
-				{
-					RemoveTagFromMaterials(Child);
-				}
-			}
-		};
+			return MaterialTag == TagName;
+		});
 		
-		RemoveTagFromMaterials(RootFolder);
+		MaterialVaultManager->SaveMaterialMetadata(Material);
 	}
 	
 	// Refresh the tags list
@@ -25,7 +25,7 @@ void SMaterialVaultFolderTreeItem::Construct(const FArguments& InArgs, const TSh
 			.Padding(0, 0, 4, 0)
 			[
 				SNew(SImage)
-				.Image(this, &SMaterialVaultFolderTreeItem::GetFolderIcon)
+				.Image(GetFolderIcon())
 				.ColorAndOpacity(FSlateColor::UseForeground())
 			]
 			+ SHorizontalBox::Slot()
@@ -33,7 +33,8 @@ void SMaterialVaultFolderTreeItem::Construct(const FArguments& InArgs, const TSh
 			.VAlign(VAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(this, &SMaterialVaultFolderTreeItem::GetFolderText)
+				.Text(GetFolderText())
+				// Bound, incremental updates keep the node and its row while its materials come and go
 				.ColorAndOpacity(this, &SMaterialVaultFolderTreeItem::GetFolderTextColor)
 				.ToolTipText(this, &SMaterialVaultFolderTreeItem::GetFolderTooltip)
 				.HighlightText_Lambda([this]() { return FText::GetEmpty(); }) // TODO: Add search highlighting
@@ -4,74 +4,199 @@
 #include "Editor.h"
 #include "EditorStyleSet.h"
 #include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+#include "Fonts/FontCache.h"
+#include "Fonts/FontMeasure.h"
+#include "Widgets/SToolTip.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Layout/SSpacer.h"
 #include "Widgets/Input/SMenuAnchor.h"
 #include "Widgets/Images/SThrobber.h"
-#include "AssetThumbnail.h"
-#include "ThumbnailRendering/ThumbnailManager.h"
+#include "SMaterialVaultThumbnail.h"
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
 #include "HAL/PlatformApplicationMisc.h"
+#include "Async/Async.h"
+#include "MaterialVaultSearchIndex.h"
 
 #define LOCTEXT_NAMESPACE "MaterialVaultMaterialGrid"
 
-void SMaterialVaultMaterialTile::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
+// Most matches a fuzzy search shows in the grid
+static const int32 MaterialVaultMaxRankedMaterials = 500;
+
+// Quiet time after the last keystroke before filtering starts
+static const float MaterialVaultFilterDebounceDelay = 0.15f;
+
+// Items filtered between checks of the cancellation flag
+static const int32 MaterialVaultFilterChunkSize = 1024;
+
+// Scrolling faster than this many rows a second requests no thumbnails, the tiles would be gone before they arrive
+static const float MaterialVaultThumbnailFlingRowsPerSecond = 20.0f;
+
+// Space between the tile's edge, its thumbnail and its name
+static const float MaterialVaultTilePadding = 4.0f;
+
+/** One filter pass over a snapshot, off the game thread. Returns false if a newer pass cancelled it. */
+static bool FilterMaterialSource(const FMaterialVaultGridFilterSource& Source, const FString& FilterText, EMaterialVaultSearchMode SearchMode, const TArray<int32>* Candidates, const FThreadSafeBool& bCancelled, TArray<int32>& OutIndices)
+{
+	if (SearchMode == EMaterialVaultSearchMode::Fuzzy)
+	{
+		return FMaterialVaultSearchIndex::RankSearchTexts(Source.SearchTexts, FilterText, MaterialVaultMaxRankedMaterials, OutIndices, &bCancelled);
+	}
+	
+	FString Query = FilterText.ToLower();
+	int32 NumCandidates = Candidates ? Candidates->Num() : Source.SearchTexts.Num();
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		if (CandidateIndex % MaterialVaultFilterChunkSize == 0 && bCancelled)
+		{
+			return false;
+		}
+		
+		int32 MaterialIndex = Candidates ? (*Candidates)[CandidateIndex] : CandidateIndex;
+		if (Source.SearchTexts[MaterialIndex].Contains(Query, ESearchCase::CaseSensitive))
+		{
+			OutIndices.Add(MaterialIndex);
+		}
+	}
+	return true;
+}
+
+void SMaterialVaultMaterialTileContent::Construct(const FArguments& InArgs)
 {
 	MaterialItem = InArgs._MaterialItem;
 	ThumbnailSize = InArgs._ThumbnailSize;
+	bThumbnailResolved = false;
+	ShapedLabelScale = 0.0f;
+	
+	LabelFont = FAppStyle::GetFontStyle("ContentBrowser.AssetTileViewNameFont");
+	LabelHeight = FSlateApplication::Get().GetRenderer()->GetFontMeasureService()->GetMaxCharacterHeight(LabelFont);
+}
 
-	// Create asset thumbnail
-	if (MaterialItem.IsValid())
+int32 SMaterialVaultMaterialTileContent::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const ESlateDrawEffect DrawEffects = ShouldBeEnabled(bParentEnabled) ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+	const FVector2f LocalSize = AllottedGeometry.GetLocalSize();
+	
+	// Thumbnail centred along the top, the class icon stands in faded while the first one loads
+	const FSlateBrush* Brush = ThumbnailBrush.IsValid() ? ThumbnailBrush.Get() : FAppStyle::GetBrush("ClassThumbnail.Material");
+	FLinearColor ThumbnailTint = InWidgetStyle.GetColorAndOpacityTint() * Brush->GetTint(InWidgetStyle);
+	if (!ThumbnailBrush.IsValid() && !bThumbnailResolved)
+	{
+		ThumbnailTint.A *= 0.25f;
+	}
+	FVector2f ThumbnailOffset((LocalSize.X - ThumbnailSize) * 0.5f, MaterialVaultTilePadding);
+	FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(FVector2f(ThumbnailSize, ThumbnailSize), FSlateLayoutTransform(ThumbnailOffset)), Brush, DrawEffects, ThumbnailTint);
+	
+	if (!MaterialItem.IsValid())
+	{
+		return LayerId;
+	}
+	
+	// The name is shaped at the painted scale, so it is only reshaped when the DPI changes
+	const float Scale = AllottedGeometry.Scale;
+	if (!ShapedLabel.IsValid() || ShapedLabelScale != Scale)
+	{
+		ShapeLabel(Scale);
+	}
+	
+	// One line centred under the thumbnail, names too long for it end in an ellipsis
+	const float InverseScale = 1.0f / Scale;
+	float LabelWidth = FMath::Min(ShapedLabel->GetMeasuredWidth() * InverseScale, LocalSize.X - MaterialVaultTilePadding * 2.0f);
+	FVector2f LabelSize(LabelWidth, ShapedLabel->GetMaxTextHeight() * InverseScale);
+	FVector2f LabelOffset((LocalSize.X - LabelWidth) * 0.5f, ThumbnailOffset.Y + ThumbnailSize + MaterialVaultTilePadding);
+	FTextOverflowArgs OverflowArgs(ShapedEllipsis, ETextOverflowDirection::LeftToRight);
+	
+	FSlateDrawElement::MakeShapedText(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(LabelSize, FSlateLayoutTransform(LabelOffset + FVector2f(1.0f, 1.0f))), ShapedLabel.ToSharedRef(), DrawEffects, InWidgetStyle.GetColorAndOpacityTint() * FLinearColor::Black, FLinearColor::Transparent, OverflowArgs);
+	FSlateDrawElement::MakeShapedText(OutDrawElements, LayerId + 2, AllottedGeometry.ToPaintGeometry(LabelSize, FSlateLayoutTransform(LabelOffset)), ShapedLabel.ToSharedRef(), DrawEffects, InWidgetStyle.GetForegroundColor(), FLinearColor::Transparent, OverflowArgs);
+	
+	return LayerId + 2;
+}
+
+FVector2D SMaterialVaultMaterialTileContent::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D(ThumbnailSize + MaterialVaultTilePadding * 2.0f, ThumbnailSize + LabelHeight + MaterialVaultTilePadding * 3.0f);
+}
+
+TSharedPtr<IToolTip> SMaterialVaultMaterialTileContent::GetToolTip()
+{
+	// Most tiles are never hovered, so their tooltip is never built
+	if (!MaterialToolTip.IsValid() && MaterialItem.IsValid())
 	{
-		FAssetThumbnailConfig ThumbnailConfig;
-		ThumbnailConfig.bAllowFadeIn = true;
-		ThumbnailConfig.bAllowHintText = true;
-		ThumbnailConfig.ThumbnailLabel = EThumbnailLabel::ClassName;
-		ThumbnailConfig.HighlightedText = FText::GetEmpty();
+		MaterialToolTip = SNew(SToolTip).Text(GetMaterialTooltip());
+	}
+	return MaterialToolTip;
+}
 
-		AssetThumbnail = MakeShareable(new FAssetThumbnail(MaterialItem->AssetData, ThumbnailSize, ThumbnailSize, UThumbnailManager::Get().GetSharedThumbnailPool()));
+void SMaterialVaultMaterialTileContent::SetThumbnailBrush(TSharedPtr<FSlateBrush> InThumbnailBrush)
+{
+	ThumbnailBrush = InThumbnailBrush;
+	bThumbnailResolved = true;
+	
+	// Tiles are only repainted when their content changes, so a new brush has to ask for it
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SMaterialVaultMaterialTileContent::ResetThumbnail()
+{
+	ThumbnailBrush.Reset();
+	bThumbnailResolved = false;
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SMaterialVaultMaterialTileContent::MarkThumbnailStale()
+{
+	bThumbnailResolved = false;
+}
+
+void SMaterialVaultMaterialTileContent::SetThumbnailSize(float InThumbnailSize)
+{
+	if (ThumbnailSize != InThumbnailSize)
+	{
+		ThumbnailSize = InThumbnailSize;
+		Invalidate(EInvalidateWidgetReason::Layout);
 	}
+}
 
+void SMaterialVaultMaterialTileContent::ShapeLabel(float FontScale) const
+{
+	TSharedRef<FSlateFontCache> FontCache = FSlateApplication::Get().GetRenderer()->GetFontCache();
+	ShapedLabel = FontCache->ShapeBidirectionalText(MaterialItem->DisplayName, LabelFont, FontScale, TextBiDi::ETextDirection::LeftToRight, ETextShapingMethod::Auto);
+	ShapedEllipsis = FontCache->ShapeBidirectionalText(TEXT("\u2026"), LabelFont, FontScale, TextBiDi::ETextDirection::LeftToRight, ETextShapingMethod::Auto);
+	ShapedLabelScale = FontScale;
+}
+
+FText SMaterialVaultMaterialTileContent::GetMaterialTooltip() const
+{
+	if (MaterialItem.IsValid())
+	{
+		FString TooltipText = FString::Printf(TEXT("Material: %s\nPath: %s\nType: %s"),
+			*MaterialItem->DisplayName,
+			*MaterialItem->AssetData.PackageName.ToString(),
+			*MaterialItem->AssetData.AssetClassPath.ToString()
+		);
+		return FText::FromString(TooltipText);
+	}
+	return FText::GetEmpty();
+}
+
+void SMaterialVaultMaterialTile::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
+{
+	MaterialItem = InArgs._MaterialItem;
+	ThumbnailSize = InArgs._ThumbnailSize;
+
+	// The row's border draws hover and selection, its one child paints the rest
 	STableRow<TSharedPtr<FMaterialVaultMaterialItem>>::Construct(
 		STableRow::FArguments()
 		.Style(FAppStyle::Get(), "TableView.Row")
 		.Padding(FMargin(2))
 		.Content()
 		[
-			SNew(SBox)
-			.Padding(4)
-			[
-				SNew(SVerticalBox)
-				+ SVerticalBox::Slot()
-				.AutoHeight()
-				.HAlign(HAlign_Center)
-				.Padding(0, 0, 0, 4)
-				[
-					SNew(SBox)
-					.WidthOverride(ThumbnailSize)
-					.HeightOverride(ThumbnailSize)
-					[
-						AssetThumbnail.IsValid() ? AssetThumbnail->MakeThumbnailWidget(FAssetThumbnailConfig()) : SNullWidget::NullWidget
-					]
-				]
-				+ SVerticalBox::Slot()
-				.AutoHeight()
-				.HAlign(HAlign_Center)
-				[
-					SNew(STextBlock)
-					.Text(this, &SMaterialVaultMaterialTile::GetMaterialName)
-					.Font(FAppStyle::GetFontStyle("ContentBrowser.AssetTileViewNameFont"))
-					.ColorAndOpacity(FSlateColor::UseForeground())
-					.ShadowColorAndOpacity(FLinearColor::Black)
-					.ShadowOffset(FVector2D(1, 1))
-					.Justification(ETextJustify::Center)
-					.WrapTextAt(ThumbnailSize)
-					.ToolTipText(this, &SMaterialVaultMaterialTile::GetMaterialTooltip)
-				]
-			]
+			SAssignNew(TileContent, SMaterialVaultMaterialTileContent)
+			.MaterialItem(MaterialItem)
+			.ThumbnailSize(ThumbnailSize)
 		],
 		InOwnerTableView
 	);
@@ -136,53 +261,36 @@ FReply SMaterialVaultMaterialTile::OnDragDetected(const FGeometry& MyGeometry, c
 	return FReply::Unhandled();
 }
 
-FText SMaterialVaultMaterialTile::GetMaterialName() const
+void SMaterialVaultMaterialTile::SetThumbnailBrush(TSharedPtr<FSlateBrush> InThumbnailBrush)
 {
-	if (MaterialItem.IsValid())
-	{
-		return FText::FromString(MaterialItem->DisplayName);
-	}
-	return FText::GetEmpty();
+	TileContent->SetThumbnailBrush(InThumbnailBrush);
 }
 
-FText SMaterialVaultMaterialTile::GetMaterialTooltip() const
+bool SMaterialVaultMaterialTile::IsThumbnailResolved() const
 {
-	if (MaterialItem.IsValid())
-	{
-		FString TooltipText = FString::Printf(TEXT("Material: %s\nPath: %s\nType: %s"),
-			*MaterialItem->DisplayName,
-			*MaterialItem->AssetData.PackageName.ToString(),
-			*MaterialItem->AssetData.AssetClassPath.ToString()
-		);
-		return FText::FromString(TooltipText);
-	}
-	return FText::GetEmpty();
+	return TileContent->IsThumbnailResolved();
 }
 
-EVisibility SMaterialVaultMaterialTile::GetLoadingVisibility() const
+void SMaterialVaultMaterialTile::SetThumbnailSize(float InThumbnailSize, bool bThumbnailStale)
 {
-	// Show loading indicator if thumbnail is not ready
-	return (AssetThumbnail.IsValid() && AssetThumbnail->GetViewportRenderTargetTexture() == nullptr) ? EVisibility::Visible : EVisibility::Collapsed;
+	ThumbnailSize = InThumbnailSize;
+	TileContent->SetThumbnailSize(InThumbnailSize);
+	if (bThumbnailStale)
+	{
+		TileContent->MarkThumbnailStale();
+	}
 }
 
 void SMaterialVaultMaterialTile::RefreshThumbnail()
 {
-	if (AssetThumbnail.IsValid())
-	{
-		AssetThumbnail->RefreshThumbnail();
-	}
+	// The grid's scheduler requests it again on its next tick
+	TileContent->ResetThumbnail();
 }
 
 void SMaterialVaultMaterialListItem::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
 {
 	MaterialItem = InArgs._MaterialItem;
 
-	// Create asset thumbnail for list view (smaller)
-	if (MaterialItem.IsValid())
-	{
-		AssetThumbnail = MakeShareable(new FAssetThumbnail(MaterialItem->AssetData, 32, 32, UThumbnailManager::Get().GetSharedThumbnailPool()));
-	}
-
 	STableRow<TSharedPtr<FMaterialVaultMaterialItem>>::Construct(
 		STableRow::FArguments()
 		.Style(FAppStyle::Get(), "ContentBrowser.AssetListView.ColumnListTableRow")
@@ -199,7 +307,10 @@ void SMaterialVaultMaterialListItem::Construct(const FArguments& InArgs, const T
 				.WidthOverride(32)
 				.HeightOverride(32)
 				[
-					AssetThumbnail.IsValid() ? AssetThumbnail->MakeThumbnailWidget() : SNullWidget::NullWidget
+					// Served from the same cache entry as the material's grid tile
+					SNew(SMaterialVaultThumbnail)
+					.AssetData(MaterialItem.IsValid() ? MaterialItem->AssetData : FAssetData())
+					.ThumbnailSize(32)
 				]
 			]
 			+ SHorizontalBox::Slot()
@@ -207,15 +318,15 @@ void SMaterialVaultMaterialListItem::Construct(const FArguments& InArgs, const T
 			.VAlign(VAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(this, &SMaterialVaultMaterialListItem::GetMaterialName)
-				.ToolTipText(this, &SMaterialVaultMaterialListItem::GetMaterialTooltip)
+				.Text(GetMaterialName())
+				.ToolTipText(GetMaterialTooltip())
 			]
 			+ SHorizontalBox::Slot()
 			.FillWidth(0.3f)
 			.VAlign(VAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(this, &SMaterialVaultMaterialListItem::GetMaterialType)
+				.Text(GetMaterialType())
 				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 			]
 			+ SHorizontalBox::Slot()
@@ -223,7 +334,7 @@ void SMaterialVaultMaterialListItem::Construct(const FArguments& InArgs, const T
 			.VAlign(VAlign_Center)
 			[
 				SNew(STextBlock)
-				.Text(this, &SMaterialVaultMaterialListItem::GetMaterialPath)
+				.Text(GetMaterialPath())
 				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 			]
 		],
@@ -318,10 +429,16 @@ void SMaterialVaultMaterialGrid::Construct(const FArguments& InArgs)
 	MaterialVaultManager = GEditor->GetEditorSubsystem<UMaterialVaultManager>();
 	ViewMode = EMaterialVaultViewMode::Grid;
 	ThumbnailSize = 128.0f;
+	ThumbnailRequestSize = GetThumbnailRequestSize(ThumbnailSize);
 	CurrentFilterText = TEXT("");
+	SearchMode = EMaterialVaultSearchMode::Substring;
+	bShowingFolder = false;
+	FilterGeneration = 0;
+	LastScrollOffset = 0.0;
+	ScrollDirection = 1;
 
-	// Create thumbnail pool
-	ThumbnailPool = MakeShareable(new FAssetThumbnailPool(1000, true));
+	// Thumbnail scheduling runs on an active timer only while the view moves, an idle grid does no per-frame work
+	SetCanTick(false);
 
 	// Create view container
 	ViewContainer = SNew(SBorder)
@@ -348,8 +465,8 @@ void SMaterialVaultMaterialGrid::Construct(const FArguments& InArgs)
 			.AutoWidth()
 			.VAlign(VAlign_Center)
 			[
-				SNew(STextBlock)
-				.Text(this, &SMaterialVaultMaterialGrid::GetStatusText)
+				SAssignNew(StatusTextBlock, STextBlock)
+				.Text(GetStatusText())
 				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 			]
 		]
@@ -364,10 +481,27 @@ void SMaterialVaultMaterialGrid::Construct(const FArguments& InArgs)
 	SwitchToViewMode(ViewMode);
 }
 
+SMaterialVaultMaterialGrid::~SMaterialVaultMaterialGrid()
+{
+	// Let an in-flight filter pass stop early, its result is dropped by the weak pointer anyway
+	if (FilterCancelFlag.IsValid())
+	{
+		*FilterCancelFlag = true;
+	}
+	
+	CancelTileThumbnails();
+}
+
 void SMaterialVaultMaterialGrid::RefreshGrid()
 {
+	// Materials or their metadata changed, the search text snapshot is rebuilt on the next filter pass
+	FilterSource.Reset();
 	UpdateFilteredMaterials();
+	RequestViewRefresh();
+}
 
+void SMaterialVaultMaterialGrid::RequestViewRefresh()
+{
 	if (TileView.IsValid())
 	{
 		TileView->RequestListRefresh();
@@ -376,12 +510,13 @@ void SMaterialVaultMaterialGrid::RefreshGrid()
 	{
 		ListView->RequestListRefresh();
 	}
+	UpdateStatusText();
 }
 
 void SMaterialVaultMaterialGrid::SetMaterials(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& InMaterials)
 {
 	AllMaterials = InMaterials;
-	UpdateFilteredMaterials();
+	bShowingFolder = false;
 	RefreshGrid();
 }
 
@@ -406,13 +541,41 @@ void SMaterialVaultMaterialGrid::SetViewMode(EMaterialVaultViewMode InViewMode)
 
 void SMaterialVaultMaterialGrid::SetThumbnailSize(float InThumbnailSize)
 {
-	ThumbnailSize = FMath::Clamp(InThumbnailSize, 32.0f, 512.0f);
+	float NewThumbnailSize = FMath::Clamp(InThumbnailSize, 32.0f, 512.0f);
+	if (NewThumbnailSize == ThumbnailSize)
+	{
+		return;
+	}
+	ThumbnailSize = NewThumbnailSize;
+	
+	// Thumbnails are only fetched again once the size needs a different downsampled level
+	int32 NewRequestSize = GetThumbnailRequestSize(ThumbnailSize);
+	bool bThumbnailsStale = NewRequestSize != ThumbnailRequestSize;
+	ThumbnailRequestSize = NewRequestSize;
+	if (bThumbnailsStale && MaterialVaultManager)
+	{
+		for (const auto& RequestPair : TileThumbnailRequests)
+		{
+			MaterialVaultManager->CancelMaterialThumbnail(RequestPair.Value.RequestId);
+		}
+		TileThumbnailRequests.Empty();
+		PrefetchedThumbnails.Empty();
+	}
 	
-	// Recreate the view with new thumbnail size
-	if (ViewMode == EMaterialVaultViewMode::Grid)
+	// Existing tiles are resized in place, the tile view picks up the new item size from its attributes
+	for (const auto& TilePair : LiveTiles)
 	{
-		SwitchToViewMode(EMaterialVaultViewMode::Grid);
+		TSharedPtr<SMaterialVaultMaterialTile> TileWidget = TilePair.Value.Pin();
+		if (TileWidget.IsValid())
+		{
+			TileWidget->SetThumbnailSize(ThumbnailSize, bThumbnailsStale);
+		}
 	}
+	if (TileView.IsValid())
+	{
+		TileView->RequestLayoutRefresh();
+	}
+	ScheduleTileThumbnailUpdate();
 }
 
 void SMaterialVaultMaterialGrid::ClearSelection()
@@ -420,25 +583,54 @@ void SMaterialVaultMaterialGrid::ClearSelection()
 	UpdateSelection(nullptr);
 }
 
-void SMaterialVaultMaterialGrid::SetFolder(const FString& FolderPath)
+void SMaterialVaultMaterialGrid::SetFolder(const FString& FolderPath, bool bForceRefresh)
 {
+	// The folder's materials only need fetching again when the folder or the catalog changed
+	if (!bForceRefresh && bShowingFolder && FolderPath == CurrentFolderPath)
+	{
+		return;
+	}
+	
 	if (MaterialVaultManager)
 	{
-		TArray<TSharedPtr<FMaterialVaultMaterialItem>> FolderMaterials = MaterialVaultManager->GetMaterialsInFolder(FolderPath);
-		SetMaterials(FolderMaterials);
+		SetMaterials(MaterialVaultManager->GetMaterialsInFolder(FolderPath));
+		bShowingFolder = true;
+		CurrentFolderPath = FolderPath;
 	}
 }
 
 void SMaterialVaultMaterialGrid::SetFilterText(const FString& FilterText)
 {
+	if (FilterText.Equals(CurrentFilterText, ESearchCase::CaseSensitive))
+	{
+		return;
+	}
+	
 	CurrentFilterText = FilterText;
-	ApplyFilters();
+	
+	// Clearing the search is instant, anything else waits for typing to pause
+	if (CurrentFilterText.IsEmpty())
+	{
+		ApplyFilters();
+		return;
+	}
+	
+	ScheduleFilterTask();
+}
+
+void SMaterialVaultMaterialGrid::SetSearchMode(EMaterialVaultSearchMode InSearchMode)
+{
+	if (SearchMode != InSearchMode)
+	{
+		SearchMode = InSearchMode;
+		ApplyFilters();
+	}
 }
 
 void SMaterialVaultMaterialGrid::ApplyFilters()
 {
 	UpdateFilteredMaterials();
-	RefreshGrid();
+	RequestViewRefresh();
 }
 
 TSharedRef<SWidget> SMaterialVaultMaterialGrid::CreateTileView()
@@ -446,16 +638,28 @@ TSharedRef<SWidget> SMaterialVaultMaterialGrid::CreateTileView()
 	TileView = SNew(STileView<TSharedPtr<FMaterialVaultMaterialItem>>)
 		.ListItemsSource(&FilteredMaterials)
 		.OnGenerateTile(this, &SMaterialVaultMaterialGrid::OnGenerateTileWidget)
+		.OnRowReleased(this, &SMaterialVaultMaterialGrid::OnTileReleased)
+		.OnTileViewScrolled(this, &SMaterialVaultMaterialGrid::OnTileViewScrolled)
 		.OnSelectionChanged(this, &SMaterialVaultMaterialGrid::OnTileSelectionChanged)
 		.OnContextMenuOpening(this, &SMaterialVaultMaterialGrid::OnContextMenuOpening)
-		.ItemWidth(ThumbnailSize + 32)
-		.ItemHeight(ThumbnailSize + 48)
+		.ItemWidth(this, &SMaterialVaultMaterialGrid::GetTileItemWidth)
+		.ItemHeight(this, &SMaterialVaultMaterialGrid::GetTileItemHeight)
 		.SelectionMode(ESelectionMode::Single)
 		.ClearSelectionOnClick(false);
 
 	return TileView.ToSharedRef();
 }
 
+float SMaterialVaultMaterialGrid::GetTileItemWidth() const
+{
+	return ThumbnailSize + 32;
+}
+
+float SMaterialVaultMaterialGrid::GetTileItemHeight() const
+{
+	return ThumbnailSize + 48;
+}
+
 TSharedRef<SWidget> SMaterialVaultMaterialGrid::CreateListView()
 {
 	ListView = SNew(SListView<TSharedPtr<FMaterialVaultMaterialItem>>)
@@ -473,6 +677,9 @@ void SMaterialVaultMaterialGrid::SwitchToViewMode(EMaterialVaultViewMode NewView
 {
 	ViewMode = NewViewMode;
 
+	// The old view's tiles go away with it
+	CancelTileThumbnails();
+	
 	TSharedRef<SWidget> NewView = (ViewMode == EMaterialVaultViewMode::Grid) ? CreateTileView() : CreateListView();
 	
 	ViewContainer->SetContent(NewView);
@@ -490,9 +697,210 @@ TSharedRef<ITableRow> SMaterialVaultMaterialGrid::OnGenerateTileWidget(TSharedPt
 	TileWidget->OnMaterialMiddleClicked.BindSP(this, &SMaterialVaultMaterialGrid::OnMaterialMiddleClicked);
 	TileWidget->OnMaterialDoubleClicked.BindSP(this, &SMaterialVaultMaterialGrid::OnMaterialDoubleClickedInternal);
 
+	// A prefetched thumbnail is shown right away, everything else waits for the scheduler
+	TSharedPtr<FSlateBrush> PrefetchedBrush;
+	if (PrefetchedThumbnails.RemoveAndCopyValue(Item, PrefetchedBrush))
+	{
+		TileWidget->SetThumbnailBrush(PrefetchedBrush);
+	}
+	LiveTiles.Add(Item, TileWidget);
+	ScheduleTileThumbnailUpdate();
+	
 	return TileWidget;
 }
 
+void SMaterialVaultMaterialGrid::OnTileReleased(const TSharedRef<ITableRow>& TileRow)
+{
+	TSharedRef<SMaterialVaultMaterialTile> TileWidget = StaticCastSharedRef<SMaterialVaultMaterialTile>(TileRow);
+	TSharedPtr<FMaterialVaultMaterialItem> Item = TileWidget->GetMaterialItem();
+	
+	// The row may already have been generated again for the same item
+	TWeakPtr<SMaterialVaultMaterialTile> LiveTile = LiveTiles.FindRef(Item);
+	if (LiveTile == TileWidget)
+	{
+		LiveTiles.Remove(Item);
+	}
+}
+
+void SMaterialVaultMaterialGrid::ScheduleTileThumbnailUpdate()
+{
+	if (!TileThumbnailTimerHandle.IsValid())
+	{
+		TileThumbnailTimerHandle = RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SMaterialVaultMaterialGrid::OnTileThumbnailTimer));
+	}
+}
+
+EActiveTimerReturnType SMaterialVaultMaterialGrid::OnTileThumbnailTimer(double InCurrentTime, float InDeltaTime)
+{
+	// An idle grid does no work at all, the timer stops once the view has settled
+	if (UpdateTileThumbnails(InDeltaTime))
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+	TileThumbnailTimerHandle.Reset();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMaterialVaultMaterialGrid::OnTileViewScrolled(double ScrollOffset)
+{
+	ScheduleTileThumbnailUpdate();
+}
+
+bool SMaterialVaultMaterialGrid::UpdateTileThumbnails(float InDeltaTime)
+{
+	if (!MaterialVaultManager || ViewMode != EMaterialVaultViewMode::Grid || !TileView.IsValid())
+	{
+		return false;
+	}
+	
+	// Visible range from the view's size and scroll offset, the offset is measured in items
+	FVector2D ViewSize = TileView->GetCachedGeometry().GetLocalSize();
+	int32 ItemsPerRow = FMath::Max(1, FMath::FloorToInt(ViewSize.X / GetTileItemWidth()));
+	int32 VisibleRows = FMath::CeilToInt(ViewSize.Y / GetTileItemHeight()) + 1;
+	double ScrollOffset = TileView->GetScrollOffset();
+	
+	double ScrollDelta = ScrollOffset - LastScrollOffset;
+	LastScrollOffset = ScrollOffset;
+	if (ScrollDelta != 0.0)
+	{
+		ScrollDirection = ScrollDelta > 0.0 ? 1 : -1;
+	}
+	float RowsPerSecond = InDeltaTime > 0.0f ? FMath::Abs(ScrollDelta) / ItemsPerRow / InDeltaTime : 0.0f;
+	bool bFlinging = RowsPerSecond > MaterialVaultThumbnailFlingRowsPerSecond;
+	
+	int32 NumItems = FilteredMaterials.Num();
+	int32 FirstVisible = FMath::Clamp(FMath::FloorToInt(ScrollOffset / ItemsPerRow) * ItemsPerRow, 0, NumItems);
+	int32 EndVisible = FMath::Min(FirstVisible + VisibleRows * ItemsPerRow, NumItems);
+	
+	// Prefetch only ahead of the scroll direction
+	int32 PrefetchItems = FMath::Max(MaterialVaultManager->GetSettings().ThumbnailPrefetchRows, 0) * ItemsPerRow;
+	int32 FirstWanted = ScrollDirection < 0 ? FMath::Max(FirstVisible - PrefetchItems, 0) : FirstVisible;
+	int32 EndWanted = ScrollDirection > 0 ? FMath::Min(EndVisible + PrefetchItems, NumItems) : EndVisible;
+	
+	TSet<TSharedPtr<FMaterialVaultMaterialItem>> WantedItems;
+	WantedItems.Reserve(EndWanted - FirstWanted);
+	for (int32 Index = FirstWanted; Index < EndWanted; ++Index)
+	{
+		WantedItems.Add(FilteredMaterials[Index]);
+	}
+	
+	// Tiles that scrolled away no longer need their thumbnail
+	for (auto It = TileThumbnailRequests.CreateIterator(); It; ++It)
+	{
+		if (!WantedItems.Contains(It.Key()))
+		{
+			MaterialVaultManager->CancelMaterialThumbnail(It.Value().RequestId);
+			It.RemoveCurrent();
+		}
+	}
+	for (auto It = PrefetchedThumbnails.CreateIterator(); It; ++It)
+	{
+		if (!WantedItems.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	
+	if (bFlinging)
+	{
+		return true;
+	}
+	
+	// On-screen tiles first, then the prefetch rows
+	for (int32 Index = FirstVisible; Index < EndVisible; ++Index)
+	{
+		RequestTileThumbnail(FilteredMaterials[Index], true);
+	}
+	for (int32 Index = FirstWanted; Index < EndWanted; ++Index)
+	{
+		if (Index < FirstVisible || Index >= EndVisible)
+		{
+			RequestTileThumbnail(FilteredMaterials[Index], false);
+		}
+	}
+	
+	// Keep going while the view is still moving or not yet arranged, a settled view has everything it needs requested
+	return ScrollDelta != 0.0 || ViewSize.IsNearlyZero();
+}
+
+void SMaterialVaultMaterialGrid::RequestTileThumbnail(TSharedPtr<FMaterialVaultMaterialItem> Item, bool bOnScreen)
+{
+	TSharedPtr<SMaterialVaultMaterialTile> TileWidget = LiveTiles.FindRef(Item).Pin();
+	if ((TileWidget.IsValid() && TileWidget->IsThumbnailResolved()) || PrefetchedThumbnails.Contains(Item))
+	{
+		return;
+	}
+	
+	// A prefetch that came on screen is requested again at on-screen priority
+	FTileThumbnailRequest* ExistingRequest = TileThumbnailRequests.Find(Item);
+	if (ExistingRequest && (ExistingRequest->bOnScreen || !bOnScreen))
+	{
+		return;
+	}
+	int32 PreviousRequestId = ExistingRequest ? ExistingRequest->RequestId : INDEX_NONE;
+	
+	// Cached thumbnails are delivered before this returns, with no request left pending
+	int32 RequestId = MaterialVaultManager->RequestMaterialThumbnail(Item, ThumbnailRequestSize, FOnMaterialVaultThumbnailReady::CreateSP(this, &SMaterialVaultMaterialGrid::OnTileThumbnailReady, TWeakPtr<FMaterialVaultMaterialItem>(Item)), bOnScreen);
+	MaterialVaultManager->CancelMaterialThumbnail(PreviousRequestId);
+	TileThumbnailRequests.Remove(Item);
+	
+	if (RequestId != INDEX_NONE)
+	{
+		FTileThumbnailRequest& Request = TileThumbnailRequests.Add(Item);
+		Request.RequestId = RequestId;
+		Request.bOnScreen = bOnScreen;
+	}
+}
+
+void SMaterialVaultMaterialGrid::OnTileThumbnailReady(TSharedPtr<FSlateBrush> Brush, bool bDropped, TWeakPtr<FMaterialVaultMaterialItem> WeakItem)
+{
+	TSharedPtr<FMaterialVaultMaterialItem> Item = WeakItem.Pin();
+	if (!Item.IsValid())
+	{
+		return;
+	}
+	
+	TileThumbnailRequests.Remove(Item);
+	
+	// Dropped from a full queue, the tile stays unresolved and the next pass asks again if it is still wanted
+	if (bDropped)
+	{
+		ScheduleTileThumbnailUpdate();
+		return;
+	}
+	
+	// Thumbnails for rows not generated yet are held until their tile appears
+	TSharedPtr<SMaterialVaultMaterialTile> TileWidget = LiveTiles.FindRef(Item).Pin();
+	if (TileWidget.IsValid())
+	{
+		TileWidget->SetThumbnailBrush(Brush);
+	}
+	else
+	{
+		PrefetchedThumbnails.Add(Item, Brush);
+	}
+}
+
+int32 SMaterialVaultMaterialGrid::GetThumbnailRequestSize(float InThumbnailSize)
+{
+	// Thumbnail levels halve from the saved size, so only a power of two boundary changes the level picked
+	return (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::CeilToInt(InThumbnailSize));
+}
+
+void SMaterialVaultMaterialGrid::CancelTileThumbnails()
+{
+	if (MaterialVaultManager)
+	{
+		for (const auto& RequestPair : TileThumbnailRequests)
+		{
+			MaterialVaultManager->CancelMaterialThumbnail(RequestPair.Value.RequestId);
+		}
+	}
+	TileThumbnailRequests.Empty();
+	PrefetchedThumbnails.Empty();
+	LiveTiles.Empty();
+}
+
 void SMaterialVaultMaterialGrid::OnTileSelectionChanged(TSharedPtr<FMaterialVaultMaterialItem> SelectedItem, ESelectInfo::Type SelectInfo)
 {
 	UpdateSelection(SelectedItem);
@@ -621,51 +1029,132 @@ void SMaterialVaultMaterialGrid::OnEditMaterialMetadata()
 
 void SMaterialVaultMaterialGrid::UpdateFilteredMaterials()
 {
-	FilteredMaterials.Empty();
+	// The source changed, so earlier results can't be refined any further
+	FilteredIndices.Reset();
+	FilteredText.Reset();
 
-	for (const auto& Material : AllMaterials)
+	if (CurrentFilterText.IsEmpty())
 	{
-		if (DoesItemPassFilter(Material))
-		{
-			FilteredMaterials.Add(Material);
-		}
+		CancelFilterTask();
+		FilteredMaterials = AllMaterials;
+		return;
 	}
+
+	StartFilterTask();
 }
 
-bool SMaterialVaultMaterialGrid::DoesItemPassFilter(TSharedPtr<FMaterialVaultMaterialItem> Item) const
+void SMaterialVaultMaterialGrid::ScheduleFilterTask()
 {
-	if (!Item.IsValid())
+	CancelFilterTask();
+	FilterTimerHandle = RegisterActiveTimer(MaterialVaultFilterDebounceDelay, FWidgetActiveTimerDelegate::CreateSP(this, &SMaterialVaultMaterialGrid::OnFilterTimer));
+}
+
+EActiveTimerReturnType SMaterialVaultMaterialGrid::OnFilterTimer(double InCurrentTime, float InDeltaTime)
+{
+	FilterTimerHandle.Reset();
+	StartFilterTask();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMaterialVaultMaterialGrid::StartFilterTask()
+{
+	CancelFilterTask();
+
+	// Snapshot the search text once per source so the task never reads items the editor may be modifying,
+	// the text is copied from the catalog's search index rather than built again per item
+	if (!FilterSource.IsValid())
 	{
-		return false;
+		TSharedRef<FMaterialVaultGridFilterSource> NewSource = MakeShared<FMaterialVaultGridFilterSource>();
+		NewSource->Materials.Reserve(AllMaterials.Num());
+		for (const TSharedPtr<FMaterialVaultMaterialItem>& Material : AllMaterials)
+		{
+			if (Material.IsValid())
+			{
+				NewSource->Materials.Add(Material);
+			}
+		}
+		if (MaterialVaultManager)
+		{
+			MaterialVaultManager->GetSearchTexts(NewSource->Materials, NewSource->SearchTexts);
+		}
+		else
+		{
+			for (const TSharedPtr<FMaterialVaultMaterialItem>& Material : NewSource->Materials)
+			{
+				NewSource->SearchTexts.Add(FMaterialVaultSearchIndex::BuildSearchText(*Material));
+			}
+		}
+		FilterSource = NewSource;
 	}
 
-	if (CurrentFilterText.IsEmpty())
+	// Anything matching a longer substring query also matched the previous one, so only those need checking again
+	bool bRefine = SearchMode == EMaterialVaultSearchMode::Substring && !FilteredText.IsEmpty() && CurrentFilterText.Contains(FilteredText);
+	TArray<int32> Candidates;
+	if (bRefine)
 	{
-		return true;
+		Candidates = FilteredIndices;
 	}
 
-	// Check name
-	if (Item->DisplayName.Contains(CurrentFilterText))
+	int32 Generation = FilterGeneration;
+	TSharedRef<FThreadSafeBool> CancelFlag = MakeShared<FThreadSafeBool>(false);
+	FilterCancelFlag = CancelFlag;
+
+	TWeakPtr<SMaterialVaultMaterialGrid> WeakGrid = SharedThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakGrid, Source = FilterSource, FilterText = CurrentFilterText, Mode = SearchMode, Candidates = MoveTemp(Candidates), bRefine, CancelFlag, Generation]()
 	{
-		return true;
+		TArray<int32> Indices;
+		if (!FilterMaterialSource(*Source, FilterText, Mode, bRefine ? &Candidates : nullptr, *CancelFlag, Indices))
+		{
+			return;
+		}
+
+		// Only the finished array crosses back to the game thread
+		AsyncTask(ENamedThreads::GameThread, [WeakGrid, Source, FilterText, Indices = MoveTemp(Indices), Generation]() mutable
+		{
+			if (TSharedPtr<SMaterialVaultMaterialGrid> Grid = WeakGrid.Pin())
+			{
+				Grid->OnFilterTaskComplete(Generation, Source, FilterText, MoveTemp(Indices));
+			}
+		});
+	});
+}
+
+void SMaterialVaultMaterialGrid::CancelFilterTask()
+{
+	if (FilterTimerHandle.IsValid())
+	{
+		UnRegisterActiveTimer(FilterTimerHandle.ToSharedRef());
+		FilterTimerHandle.Reset();
 	}
 
-	// Check path
-	if (Item->AssetData.PackagePath.ToString().Contains(CurrentFilterText))
+	if (FilterCancelFlag.IsValid())
 	{
-		return true;
+		*FilterCancelFlag = true;
+		FilterCancelFlag.Reset();
 	}
 
-	// Check metadata tags
-	for (const FString& ItemTag : Item->Metadata.Tags)
+	++FilterGeneration;
+}
+
+void SMaterialVaultMaterialGrid::OnFilterTaskComplete(int32 Generation, TSharedPtr<const FMaterialVaultGridFilterSource> Source, const FString& FilterText, TArray<int32> Indices)
+{
+	// A newer query, folder or search mode has been requested since this pass started
+	if (Generation != FilterGeneration)
 	{
-		if (ItemTag.Contains(CurrentFilterText))
-		{
-			return true;
-		}
+		return;
 	}
 
-	return false;
+	FilterCancelFlag.Reset();
+	FilteredText = FilterText;
+	FilteredIndices = MoveTemp(Indices);
+
+	FilteredMaterials.Reset(FilteredIndices.Num());
+	for (int32 MaterialIndex : FilteredIndices)
+	{
+		FilteredMaterials.Add(Source->Materials[MaterialIndex]);
+	}
+
+	RequestViewRefresh();
 }
 
 void SMaterialVaultMaterialGrid::UpdateSelection(TSharedPtr<FMaterialVaultMaterialItem> NewSelection)
@@ -719,4 +1208,12 @@ FText SMaterialVaultMaterialGrid::GetStatusText() const
 	}
 }
 
+void SMaterialVaultMaterialGrid::UpdateStatusText()
+{
+	if (StatusTextBlock.IsValid())
+	{
+		StatusTextBlock->SetText(GetStatusText());
+	}
+}
+
 #undef LOCTEXT_NAMESPACE 
\ No newline at end of file
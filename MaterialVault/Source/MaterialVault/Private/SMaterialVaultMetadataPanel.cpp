@@ -9,8 +9,8 @@
 #include "Widgets/Layout/SUniformGridPanel.h"
 #include "Widgets/Input/SHyperlink.h"
 #include "Widgets/Images/SThrobber.h"
-#include "AssetThumbnail.h"
-#include "ThumbnailRendering/ThumbnailManager.h"
+#include "SMaterialVaultThumbnail.h"
+#include "AssetRegistry/IAssetRegistry.h"
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
 #include "ToolMenus.h"
@@ -178,12 +178,13 @@ void SMaterialVaultTagEditor::NotifyTagsChanged()
 void SMaterialVaultTextureItem::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
 {
 	TextureItem = InArgs._TextureItem;
+	MaterialVaultManager = GEditor->GetEditorSubsystem<UMaterialVaultManager>();
 
-	// Create asset thumbnail
+	// Registry data works whether or not the texture is loaded
+	FAssetData TextureAssetData;
 	if (TextureItem.IsValid() && !TextureItem->Texture.IsNull())
 	{
-		FAssetData TextureAssetData = FAssetData(TextureItem->Texture.Get());
-		AssetThumbnail = MakeShareable(new FAssetThumbnail(TextureAssetData, 32, 32, UThumbnailManager::Get().GetSharedThumbnailPool()));
+		TextureAssetData = IAssetRegistry::GetChecked().GetAssetByObjectPath(TextureItem->Texture.ToSoftObjectPath());
 	}
 
 	STableRow<TSharedPtr<FMaterialVaultTextureItem>>::Construct(
@@ -202,7 +203,9 @@ void SMaterialVaultTextureItem::Construct(const FArguments& InArgs, const TShare
 				.WidthOverride(32)
 				.HeightOverride(32)
 				[
-					AssetThumbnail.IsValid() ? AssetThumbnail->MakeThumbnailWidget() : SNullWidget::NullWidget
+					SNew(SMaterialVaultThumbnail)
+					.AssetData(TextureAssetData)
+					.ThumbnailSize(32)
 				]
 			]
 			+ SHorizontalBox::Slot()
@@ -214,18 +217,29 @@ void SMaterialVaultTextureItem::Construct(const FArguments& InArgs, const TShare
 				.AutoHeight()
 				[
 					SNew(STextBlock)
-					.Text(this, &SMaterialVaultTextureItem::GetTextureName)
+					.Text(GetTextureName())
 					.Font(FAppStyle::GetFontStyle("PropertyWindow.NormalFont"))
-					.ToolTipText(this, &SMaterialVaultTextureItem::GetTextureTooltip)
+					.ToolTipText(GetTextureTooltip())
 				]
 				+ SVerticalBox::Slot()
 				.AutoHeight()
 				[
+					// Bound, texture info is read from disk in the background and fills in after the row is built
 					SNew(STextBlock)
 					.Text(this, &SMaterialVaultTextureItem::GetTextureInfo)
 					.Font(FAppStyle::GetFontStyle("PropertyWindow.SmallFont"))
 					.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.HAlign(HAlign_Left)
+				[
+					SNew(SHyperlink)
+					.Text(GetTextureUsersText())
+					.ToolTipText(LOCTEXT("TextureUsersTooltip", "Show the materials that use this texture"))
+					.Visibility(GetTextureUsersVisibility())
+					.OnNavigate(this, &SMaterialVaultTextureItem::OnTextureUsersNavigate)
+				]
 			]
 		],
 		InOwnerTableView
@@ -254,15 +268,31 @@ FText SMaterialVaultTextureItem::GetTextureName() const
 
 FText SMaterialVaultTextureItem::GetTextureInfo() const
 {
-	if (TextureItem.IsValid() && !TextureItem->Texture.IsNull())
+	if (TextureItem.IsValid() && !TextureItem->Texture.IsNull() && MaterialVaultManager)
 	{
-		UTexture2D* LoadedTexture = TextureItem->Texture.LoadSynchronous();
-		if (LoadedTexture)
+		// Evaluated every paint, so this only ever reads the manager's cache or registry tags
+		FMaterialVaultTextureInfo TextureInfo;
+		if (!MaterialVaultManager->GetTextureInfo(TextureItem->Texture.ToSoftObjectPath(), TextureInfo))
 		{
-			return FText::Format(LOCTEXT("TextureInfoFormat", "{0}x{1}"), 
-				FText::AsNumber(LoadedTexture->GetSizeX()), 
-				FText::AsNumber(LoadedTexture->GetSizeY()));
+			return LOCTEXT("TextureInfoPending", "Loading texture info...");
 		}
+		if (TextureInfo.bMissing)
+		{
+			return LOCTEXT("TextureInfoMissing", "Texture not found");
+		}
+
+		FString FormatName = TextureInfo.Format;
+		FormatName.RemoveFromStart(TEXT("PF_"));
+
+		if (TextureInfo.Width > 0 && TextureInfo.Height > 0)
+		{
+			return FText::Format(LOCTEXT("TextureInfoFormat", "{0}x{1}  {2}  {3}"),
+				FText::AsNumber(TextureInfo.Width, &FNumberFormattingOptions::DefaultNoGrouping()),
+				FText::AsNumber(TextureInfo.Height, &FNumberFormattingOptions::DefaultNoGrouping()),
+				FText::FromString(FormatName),
+				FText::AsMemory(TextureInfo.DiskSize));
+		}
+		return FText::AsMemory(TextureInfo.DiskSize);
 	}
 	return FText::GetEmpty();
 }
@@ -280,11 +310,35 @@ FText SMaterialVaultTextureItem::GetTextureTooltip() const
 	return FText::GetEmpty();
 }
 
+FText SMaterialVaultTextureItem::GetTextureUsersText() const
+{
+	int32 UserCount = TextureItem.IsValid() ? TextureItem->UserCount : 0;
+	return FText::Format(LOCTEXT("TextureUsersFormat", "Used by {0} {0}|plural(one=material,other=materials)"), UserCount);
+}
+
+EVisibility SMaterialVaultTextureItem::GetTextureUsersVisibility() const
+{
+	return TextureItem.IsValid() && TextureItem->UserCount > 0 ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+void SMaterialVaultTextureItem::OnTextureUsersNavigate()
+{
+	if (TextureItem.IsValid())
+	{
+		OnTextureUsersClicked.ExecuteIfBound(TextureItem->Texture);
+	}
+}
+
 void SMaterialVaultTextureDependencies::Construct(const FArguments& InArgs)
 {
 	MaterialItem = InArgs._MaterialItem;
 	MaterialVaultManager = GEditor->GetEditorSubsystem<UMaterialVaultManager>();
 
+	if (MaterialVaultManager)
+	{
+		MaterialVaultManager->OnMaterialDependenciesResolved.AddSP(this, &SMaterialVaultTextureDependencies::OnDependenciesResolved);
+	}
+
 	ChildSlot
 	[
 			SAssignNew(TextureListView, SListView<TSharedPtr<FMaterialVaultTextureItem>>)
@@ -308,6 +362,7 @@ TSharedRef<ITableRow> SMaterialVaultTextureDependencies::OnGenerateTextureWidget
 		.TextureItem(Item);
 
 	TextureWidget->OnTextureDoubleClicked.BindSP(this, &SMaterialVaultTextureDependencies::OnTextureDoubleClicked);
+	TextureWidget->OnTextureUsersClicked.BindSP(this, &SMaterialVaultTextureDependencies::OnTextureUsersClicked);
 
 	return TextureWidget;
 }
@@ -318,16 +373,17 @@ void SMaterialVaultTextureDependencies::RefreshTextureDependencies()
 
 	if (MaterialItem.IsValid() && MaterialVaultManager)
 	{
-		// Load dependencies if not already loaded
-		if (MaterialItem->TextureDependencies.Num() == 0)
+		// Resolved in the background, the list fills in once the result arrives
+		if (!MaterialItem->bDependenciesResolved)
 		{
-			MaterialVaultManager->LoadMaterialDependencies(MaterialItem);
+			MaterialVaultManager->RequestMaterialDependencies(MaterialItem);
 		}
 
-		// Convert to wrapper items
+		// Convert to wrapper items, user counts come straight from the reverse index
 		for (const auto& TexturePtr : MaterialItem->TextureDependencies)
 		{
-			TextureDependencies.Add(MakeShareable(new FMaterialVaultTextureItem(TexturePtr)));
+			int32 UserCount = MaterialVaultManager->GetTextureUserCount(TexturePtr.ToSoftObjectPath());
+			TextureDependencies.Add(MakeShareable(new FMaterialVaultTextureItem(TexturePtr, UserCount)));
 		}
 	}
 
@@ -337,12 +393,22 @@ void SMaterialVaultTextureDependencies::RefreshTextureDependencies()
 	}
 }
 
+void SMaterialVaultTextureDependencies::OnDependenciesResolved(TSharedPtr<FMaterialVaultMaterialItem> ResolvedItem)
+{
+	// Match by path, a catalog rebuild may have replaced the item being shown
+	if (MaterialItem.IsValid() && ResolvedItem.IsValid() && MaterialItem->AssetData.GetSoftObjectPath() == ResolvedItem->AssetData.GetSoftObjectPath())
+	{
+		MaterialItem = ResolvedItem;
+		RefreshTextureDependencies();
+	}
+}
+
 void SMaterialVaultTextureDependencies::OnTextureDoubleClicked(TSoftObjectPtr<UTexture2D> Texture)
 {
 	if (!Texture.IsNull())
 	{
 		// Browse to texture in Content Browser
-		FAssetData AssetData = FAssetData(Texture.Get());
+		FAssetData AssetData = IAssetRegistry::GetChecked().GetAssetByObjectPath(Texture.ToSoftObjectPath());
 		TArray<FAssetData> AssetDataArray;
 		AssetDataArray.Add(AssetData);
 
@@ -351,11 +417,22 @@ void SMaterialVaultTextureDependencies::OnTextureDoubleClicked(TSoftObjectPtr<UT
 	}
 }
 
+void SMaterialVaultTextureDependencies::OnTextureUsersClicked(TSoftObjectPtr<UTexture2D> Texture)
+{
+	OnShowTextureUsers.ExecuteIfBound(Texture);
+}
+
 void SMaterialVaultMetadataPanel::Construct(const FArguments& InArgs)
 {
 	MaterialVaultManager = GEditor->GetEditorSubsystem<UMaterialVaultManager>();
 	bHasUnsavedChanges = false;
 
+	// Sizes of added or re-saved materials arrive with their dependency walk
+	if (MaterialVaultManager)
+	{
+		MaterialVaultManager->OnMaterialDependenciesResolved.AddSP(this, &SMaterialVaultMetadataPanel::OnDependenciesResolved);
+	}
+
 	ChildSlot
 	[
 		SNew(SBorder)
@@ -379,10 +456,9 @@ void SMaterialVaultMetadataPanel::Construct(const FArguments& InArgs)
 				+ SOverlay::Slot()
 				[
 					// No selection message
-					SNew(SBox)
+					SAssignNew(NoSelectionBox, SBox)
 					.HAlign(HAlign_Center)
 					.VAlign(VAlign_Center)
-					.Visibility(this, &SMaterialVaultMetadataPanel::GetNoSelectionVisibility)
 					[
 						SNew(STextBlock)
 						.Text(LOCTEXT("NoMaterialSelected", "Select a material to view its metadata"))
@@ -394,7 +470,6 @@ void SMaterialVaultMetadataPanel::Construct(const FArguments& InArgs)
 				[
 					// Content
 					SAssignNew(ContentScrollBox, SScrollBox)
-					.Visibility(this, &SMaterialVaultMetadataPanel::GetContentVisibility)
 					+ SScrollBox::Slot()
 					[
 						SNew(SVerticalBox)
@@ -438,6 +513,22 @@ void SMaterialVaultMetadataPanel::Construct(const FArguments& InArgs)
 			]
 		]
 	];
+
+	if (TextureDependencies.IsValid())
+	{
+		TextureDependencies->OnShowTextureUsers.BindSP(this, &SMaterialVaultMetadataPanel::OnTextureUsersRequested);
+	}
+	
+	UpdateUI();
+}
+
+void SMaterialVaultMetadataPanel::OnDependenciesResolved(TSharedPtr<FMaterialVaultMaterialItem> ResolvedItem)
+{
+	// Match by path, a catalog rebuild may have replaced the item being shown; its sizes are on the resolved one
+	if (SizeTextBlock.IsValid() && MaterialItem.IsValid() && ResolvedItem.IsValid() && MaterialItem->AssetData.GetSoftObjectPath() == ResolvedItem->AssetData.GetSoftObjectPath())
+	{
+		SizeTextBlock->SetText(GetMaterialSizeText(ResolvedItem));
+	}
 }
 
 void SMaterialVaultMetadataPanel::SetMaterialItem(TSharedPtr<FMaterialVaultMaterialItem> InMaterialItem)
@@ -507,7 +598,7 @@ void SMaterialVaultMetadataPanel::SaveMetadata()
 		
 		MaterialVaultManager->SaveMaterialMetadata(MaterialItem);
 		OriginalMetadata = MaterialItem->Metadata;
-		bHasUnsavedChanges = false;
+		MarkAsClean();
 		OnMetadataChanged.ExecuteIfBound(MaterialItem);
 	}
 }
@@ -557,9 +648,11 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateMaterialPreview()
 					.HAlign(HAlign_Center)
 					.VAlign(VAlign_Center)
 					[
-						SNew(STextBlock)
-						.Text(LOCTEXT("MaterialPreview", "Material Preview\n(Right-click to change thumbnail)"))
-						.Justification(ETextJustify::Center)
+						// Shares the cached thumbnail of the material's grid tile, only the largest level is picked
+						SAssignNew(PreviewThumbnail, SMaterialVaultThumbnail)
+						.AssetData(MaterialItem.IsValid() ? MaterialItem->AssetData : FAssetData())
+						.ThumbnailSize(256)
+						.ToolTipText(LOCTEXT("MaterialPreview", "Material Preview\n(Right-click to change thumbnail)"))
 					]
 				]
 			]
@@ -626,7 +719,6 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateBasicProperties()
 				+ SUniformGridPanel::Slot(1, 0)
 				[
 					SAssignNew(MaterialNameTextBox, SEditableTextBox)
-					.IsEnabled(this, &SMaterialVaultMetadataPanel::IsEnabled)
 					.OnTextChanged(this, &SMaterialVaultMetadataPanel::OnMaterialNameChanged)
 					.ToolTipText(LOCTEXT("MaterialNameTooltip", "Display name for this material (metadata only, does not rename the actual asset)"))
 				]
@@ -651,7 +743,6 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateBasicProperties()
 				+ SUniformGridPanel::Slot(1, 2)
 				[
 					SAssignNew(AuthorTextBox, SEditableTextBox)
-					.IsEnabled(this, &SMaterialVaultMetadataPanel::IsEnabled)
 					.OnTextChanged(this, &SMaterialVaultMetadataPanel::OnAuthorChanged)
 				]
 				+ SUniformGridPanel::Slot(0, 3)
@@ -663,7 +754,6 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateBasicProperties()
 				+ SUniformGridPanel::Slot(1, 3)
 				[
 					SAssignNew(CategoryTextBox, SEditableTextBox)
-					.IsEnabled(this, &SMaterialVaultMetadataPanel::IsEnabled)
 					.OnTextChanged(this, &SMaterialVaultMetadataPanel::OnCategoryChanged)
 				]
 				+ SUniformGridPanel::Slot(0, 4)
@@ -678,6 +768,19 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateBasicProperties()
 					.Font(FAppStyle::GetFontStyle("PropertyWindow.NormalFont"))
 					.ColorAndOpacity(FSlateColor::UseSubduedForeground())
 				]
+				+ SUniformGridPanel::Slot(0, 5)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("SizeLabel", "Size:"))
+					.Font(FAppStyle::GetFontStyle("PropertyWindow.NormalFont"))
+				]
+				+ SUniformGridPanel::Slot(1, 5)
+				[
+					SAssignNew(SizeTextBlock, STextBlock)
+					.Font(FAppStyle::GetFontStyle("PropertyWindow.NormalFont"))
+					.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+					.ToolTipText(LOCTEXT("SizeTooltip", "Package size on disk, and the estimated footprint including every hard-referenced package such as textures"))
+				]
 			]
 		];
 }
@@ -732,7 +835,6 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateNotesSection()
 				.HeightOverride(80)
 				[
 					SAssignNew(NotesTextBox, SMultiLineEditableTextBox)
-					.IsEnabled(this, &SMaterialVaultMetadataPanel::IsEnabled)
 					.OnTextChanged(this, &SMaterialVaultMetadataPanel::OnNotesChanged)
 					.WrapTextAt(0)
 				]
@@ -787,7 +889,6 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateActionButtons()
 				SAssignNew(RevertButton, SButton)
 				.ButtonStyle(FAppStyle::Get(), "FlatButton")
 				.OnClicked(this, &SMaterialVaultMetadataPanel::OnRevertClicked)
-				.IsEnabled_Lambda([this]() { return bHasUnsavedChanges; })
 				.ToolTipText(LOCTEXT("RevertTooltip", "Revert changes"))
 				[
 					SNew(STextBlock)
@@ -800,12 +901,10 @@ TSharedRef<SWidget> SMaterialVaultMetadataPanel::CreateActionButtons()
 				SAssignNew(SaveButton, SButton)
 				.ButtonStyle(FAppStyle::Get(), "FlatButton.Success")
 				.OnClicked(this, &SMaterialVaultMetadataPanel::OnSaveClicked)
-				.Visibility(this, &SMaterialVaultMetadataPanel::GetSaveButtonVisibility)
 				.ToolTipText(LOCTEXT("SaveTooltip", "Save metadata changes"))
 				[
-					SNew(STextBlock)
+					SAssignNew(SaveButtonText, STextBlock)
 					.Text(LOCTEXT("SaveButton", "Save"))
-					.ColorAndOpacity(this, &SMaterialVaultMetadataPanel::GetSaveButtonColor)
 				]
 			]
 		];
@@ -857,6 +956,11 @@ void SMaterialVaultMetadataPanel::OnTagsChanged(const TArray<FString>& NewTags)
 	}
 }
 
+void SMaterialVaultMetadataPanel::OnTextureUsersRequested(TSoftObjectPtr<UTexture2D> Texture)
+{
+	OnShowTextureUsers.ExecuteIfBound(Texture);
+}
+
 FReply SMaterialVaultMetadataPanel::OnSaveClicked()
 {
 	SaveMetadata();
@@ -906,6 +1010,45 @@ FReply SMaterialVaultMetadataPanel::OnOpenMaterialEditorClicked()
 
 void SMaterialVaultMetadataPanel::UpdateUI()
 {
+	// Widget state is pushed from here rather than bound, so an idle panel is never re-evaluated
+	if (NoSelectionBox.IsValid())
+	{
+		NoSelectionBox->SetVisibility(GetNoSelectionVisibility());
+	}
+	
+	if (ContentScrollBox.IsValid())
+	{
+		ContentScrollBox->SetVisibility(GetContentVisibility());
+	}
+	
+	const bool bEditable = IsEnabled();
+	if (MaterialNameTextBox.IsValid())
+	{
+		MaterialNameTextBox->SetEnabled(bEditable);
+	}
+	
+	if (AuthorTextBox.IsValid())
+	{
+		AuthorTextBox->SetEnabled(bEditable);
+	}
+	
+	if (CategoryTextBox.IsValid())
+	{
+		CategoryTextBox->SetEnabled(bEditable);
+	}
+	
+	if (NotesTextBox.IsValid())
+	{
+		NotesTextBox->SetEnabled(bEditable);
+	}
+	
+	if (SizeTextBlock.IsValid())
+	{
+		SizeTextBlock->SetText(GetMaterialSizeText(MaterialItem));
+	}
+	
+	UpdateSaveState();
+	
 	if (MaterialItem.IsValid())
 	{
 		// Update text boxes
@@ -951,6 +1094,11 @@ void SMaterialVaultMetadataPanel::UpdateUI()
 		{
 			TextureDependencies->SetMaterialItem(MaterialItem);
 		}
+		
+		if (PreviewThumbnail.IsValid())
+		{
+			PreviewThumbnail->SetAssetData(MaterialItem->AssetData);
+		}
 	}
 }
 
@@ -963,12 +1111,32 @@ void SMaterialVaultMetadataPanel::MarkAsChanged()
 		{
 			MaterialItem->Metadata.LastModified = FDateTime::Now();
 		}
+		UpdateSaveState();
 	}
 }
 
 void SMaterialVaultMetadataPanel::MarkAsClean()
 {
 	bHasUnsavedChanges = false;
+	UpdateSaveState();
+}
+
+void SMaterialVaultMetadataPanel::UpdateSaveState()
+{
+	if (SaveButton.IsValid())
+	{
+		SaveButton->SetVisibility(GetSaveButtonVisibility());
+	}
+	
+	if (SaveButtonText.IsValid())
+	{
+		SaveButtonText->SetColorAndOpacity(GetSaveButtonColor());
+	}
+	
+	if (RevertButton.IsValid())
+	{
+		RevertButton->SetEnabled(bHasUnsavedChanges);
+	}
 }
 
 bool SMaterialVaultMetadataPanel::IsEnabled() const
@@ -985,10 +1153,16 @@ FText SMaterialVaultMetadataPanel::GetMaterialTypeText() const
 	return FText::GetEmpty();
 }
 
-FText SMaterialVaultMetadataPanel::GetMaterialSizeText() const
+FText SMaterialVaultMetadataPanel::GetMaterialSizeText(const TSharedPtr<FMaterialVaultMaterialItem>& SizedItem)
 {
-	// TODO: Calculate material memory usage
-	return LOCTEXT("SizeUnknown", "Size: Unknown");
+	// Sizes come from asset registry package data, gathered when the catalog was built or the dependency walk finished
+	if (!SizedItem.IsValid() || SizedItem->DiskSize <= 0)
+	{
+		return LOCTEXT("SizeUnknown", "Unknown");
+	}
+	
+	return FText::Format(LOCTEXT("SizeFormat", "{0} on disk, ~{1} with dependencies"),
+		FText::AsMemory(SizedItem->DiskSize), FText::AsMemory(SizedItem->ResourceSize));
 }
 
 EVisibility SMaterialVaultMetadataPanel::GetNoSelectionVisibility() const
@@ -0,0 +1,139 @@
+#include "SMaterialVaultThumbnail.h"
+#include "MaterialVaultManager.h"
+#include "Editor.h"
+#include "Styling/AppStyle.h"
+#include "Styling/SlateIconFinder.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Images/SThrobber.h"
+
+void SMaterialVaultThumbnail::Construct(const FArguments& InArgs)
+{
+	AssetData = InArgs._AssetData;
+	ThumbnailSize = InArgs._ThumbnailSize;
+	ThumbnailBrush.Reset();
+	bThumbnailResolved = false;
+	RequestId = INDEX_NONE;
+	MaterialVaultManager = GEditor ? GEditor->GetEditorSubsystem<UMaterialVaultManager>() : nullptr;
+	
+	ChildSlot
+	[
+		SNew(SOverlay)
+		+ SOverlay::Slot()
+		[
+			SAssignNew(ThumbnailImage, SImage)
+		]
+		+ SOverlay::Slot()
+		.HAlign(HAlign_Center)
+		.VAlign(VAlign_Center)
+		[
+			SAssignNew(LoadingThrobber, SCircularThrobber)
+			.Radius(FMath::Min(ThumbnailSize / 4.0f, 16.0f))
+		]
+	];
+	
+	RequestThumbnail();
+	UpdateThumbnailWidgets();
+}
+
+SMaterialVaultThumbnail::~SMaterialVaultThumbnail()
+{
+	CancelThumbnailRequest();
+}
+
+void SMaterialVaultThumbnail::SetAssetData(const FAssetData& InAssetData)
+{
+	if (InAssetData.GetSoftObjectPath() == AssetData.GetSoftObjectPath())
+	{
+		return;
+	}
+	
+	CancelThumbnailRequest();
+	AssetData = InAssetData;
+	ThumbnailBrush.Reset();
+	bThumbnailResolved = false;
+	RequestThumbnail();
+	UpdateThumbnailWidgets();
+}
+
+void SMaterialVaultThumbnail::RequestThumbnail()
+{
+	if (!MaterialVaultManager || !AssetData.IsValid())
+	{
+		bThumbnailResolved = true;
+		return;
+	}
+	
+	// A visible widget asked for it, so it goes ahead of the grid's prefetches; cached thumbnails arrive before this returns
+	RequestId = MaterialVaultManager->RequestAssetThumbnail(AssetData, ThumbnailSize, FOnMaterialVaultThumbnailReady::CreateSP(this, &SMaterialVaultThumbnail::OnThumbnailReady), true);
+}
+
+void SMaterialVaultThumbnail::CancelThumbnailRequest()
+{
+	if (MaterialVaultManager && RequestId != INDEX_NONE)
+	{
+		MaterialVaultManager->CancelMaterialThumbnail(RequestId);
+	}
+	RequestId = INDEX_NONE;
+}
+
+void SMaterialVaultThumbnail::OnThumbnailReady(TSharedPtr<FSlateBrush> Brush, bool bDropped)
+{
+	RequestId = INDEX_NONE;
+	
+	// Dropped from a full queue, ask again next frame rather than from inside the manager's queue update
+	if (bDropped)
+	{
+		RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SMaterialVaultThumbnail::OnRetryThumbnailRequest));
+		return;
+	}
+	
+	ThumbnailBrush = Brush;
+	bThumbnailResolved = true;
+	UpdateThumbnailWidgets();
+}
+
+EActiveTimerReturnType SMaterialVaultThumbnail::OnRetryThumbnailRequest(double InCurrentTime, float InDeltaTime)
+{
+	// Another asset may have been set meanwhile, its request is already out
+	if (RequestId == INDEX_NONE && !bThumbnailResolved)
+	{
+		RequestThumbnail();
+		UpdateThumbnailWidgets();
+	}
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMaterialVaultThumbnail::UpdateThumbnailWidgets()
+{
+	// Pushed on change rather than bound, so an idle thumbnail costs nothing per frame
+	if (ThumbnailImage.IsValid())
+	{
+		ThumbnailImage->SetImage(GetThumbnailBrush());
+	}
+	if (LoadingThrobber.IsValid())
+	{
+		LoadingThrobber->SetVisibility(GetLoadingVisibility());
+	}
+}
+
+const FSlateBrush* SMaterialVaultThumbnail::GetThumbnailBrush() const
+{
+	if (ThumbnailBrush.IsValid())
+	{
+		return ThumbnailBrush.Get();
+	}
+	
+	// Packages saved without a thumbnail show their class icon, nothing is drawn while loading
+	if (!bThumbnailResolved)
+	{
+		return nullptr;
+	}
+	const FSlateBrush* ClassBrush = FSlateIconFinder::FindIconBrushForClass(AssetData.GetClass(), TEXT("ClassThumbnail"));
+	return ClassBrush ? ClassBrush : FAppStyle::GetBrush("ClassThumbnail.Material");
+}
+
+EVisibility SMaterialVaultThumbnail::GetLoadingVisibility() const
+{
+	return bThumbnailResolved ? EVisibility::Collapsed : EVisibility::Visible;
+}
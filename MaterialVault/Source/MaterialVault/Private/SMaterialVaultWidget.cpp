@@ -7,11 +7,13 @@
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SSplitter.h"
+#include "Widgets/SInvalidationPanel.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/Input/SSlider.h"
 #include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SCheckBox.h"
 #include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Docking/SDockTab.h"
@@ -33,20 +35,26 @@ void SMaterialVaultWidget::Construct(const FArguments& InArgs)
 	// Initialize settings
 	CurrentSettings = FMaterialVaultSettings();
 	
+	// Nothing here animates on its own, panels push their changes and the tab is only repainted when they do
+	SetCanTick(false);
+	
 	// Create the main layout
 	ChildSlot
 	[
-		SNew(SVerticalBox)
-		+ SVerticalBox::Slot()
-		.AutoHeight()
-		.Padding(2.0f)
-		[
-			CreateToolbar()
-		]
-		+ SVerticalBox::Slot()
-		.FillHeight(1.0f)
+		SNew(SInvalidationPanel)
 		[
-			CreateMainContent()
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(2.0f)
+			[
+				CreateToolbar()
+			]
+			+ SVerticalBox::Slot()
+			.FillHeight(1.0f)
+			[
+				CreateMainContent()
+			]
 		]
 	];
 	
@@ -82,19 +90,13 @@ void SMaterialVaultWidget::Construct(const FArguments& InArgs)
 	if (MetadataWidget.IsValid())
 	{
 		MetadataWidget->OnMetadataChanged.BindSP(this, &SMaterialVaultWidget::OnMetadataChanged);
+		MetadataWidget->OnShowTextureUsers.BindSP(this, &SMaterialVaultWidget::OnShowTextureUsers);
 	}
 	
 	// Initial refresh
 	RefreshInterface();
 }
 
-void SMaterialVaultWidget::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
-{
-	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
-	
-	// Update thumbnails or other time-based operations if needed
-}
-
 void SMaterialVaultWidget::RefreshInterface()
 {
 	if (MaterialVaultManager)
@@ -152,7 +154,7 @@ void SMaterialVaultWidget::RefreshInterface()
 		}
 		
 		// Update the material grid with restored selection
-		UpdateMaterialGrid();
+		UpdateMaterialGrid(true);
 	}
 }
 
@@ -210,6 +212,22 @@ TSharedRef<SWidget> SMaterialVaultWidget::CreateToolbar()
 				.HintText(NSLOCTEXT("MaterialVault", "SearchHint", "Search materials..."))
 			]
 			
+			// Fuzzy search toggle
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(2.0f)
+			[
+				SNew(SCheckBox)
+				.IsChecked(this, &SMaterialVaultWidget::GetFuzzySearchCheckState)
+				.OnCheckStateChanged(this, &SMaterialVaultWidget::OnFuzzySearchCheckStateChanged)
+				.ToolTipText(NSLOCTEXT("MaterialVault", "FuzzySearchTooltip", "Tolerate typos and show the best matches first"))
+				[
+					SNew(STextBlock)
+					.Text(NSLOCTEXT("MaterialVault", "FuzzySearch", "Fuzzy"))
+				]
+			]
+			
 			// Thumbnail size slider
 			+ SHorizontalBox::Slot()
 			.AutoWidth()
@@ -391,19 +409,40 @@ void SMaterialVaultWidget::OnThumbnailSizeChanged(float NewSize)
 void SMaterialVaultWidget::OnSearchTextChanged(const FText& SearchText)
 {
 	CurrentSearchText = SearchText.ToString();
-	UpdateMaterialGrid();
+	
+	// Typing doesn't change what is shown, only how it is filtered
+	if (MaterialGridWidget.IsValid())
+	{
+		MaterialGridWidget->SetFilterText(CurrentSearchText);
+	}
+}
+
+ECheckBoxState SMaterialVaultWidget::GetFuzzySearchCheckState() const
+{
+	return CurrentSettings.SearchMode == EMaterialVaultSearchMode::Fuzzy ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SMaterialVaultWidget::OnFuzzySearchCheckStateChanged(ECheckBoxState NewState)
+{
+	CurrentSettings.SearchMode = NewState == ECheckBoxState::Checked ? EMaterialVaultSearchMode::Fuzzy : EMaterialVaultSearchMode::Substring;
+	ApplySettings();
 }
 
 void SMaterialVaultWidget::OnSortModeChanged(EMaterialVaultSortMode NewSortMode)
 {
 	CurrentSettings.SortMode = NewSortMode;
 	ApplySettings();
+	
+	// Folders keep every order sorted, so switching only fetches a different list; other lists are sorted again
+	UpdateMaterialGrid(true);
 }
 
 void SMaterialVaultWidget::OnFolderSelected(TSharedPtr<FMaterialVaultFolderNode> SelectedFolder)
 {
 	CurrentSelectedFolder = SelectedFolder;
 	CurrentSelectedCategory.Reset(); // Clear category selection when folder is selected
+	CurrentSelectedTag.Reset();
+	CurrentSelectedTexture.Reset();
 	UpdateMaterialGrid();
 }
 
@@ -412,6 +451,7 @@ void SMaterialVaultWidget::OnCategorySelected(TSharedPtr<FMaterialVaultCategoryI
 	CurrentSelectedCategory = SelectedCategory;
 	CurrentSelectedFolder.Reset(); // Clear folder selection when category is selected
 	CurrentSelectedTag.Reset(); // Clear tag selection when category is selected
+	CurrentSelectedTexture.Reset();
 	UpdateMaterialGridFromCategory();
 }
 
@@ -421,6 +461,7 @@ void SMaterialVaultWidget::OnTagSelected(FString SelectedTag)
 	CurrentSelectedTag = SelectedTag;
 	CurrentSelectedFolder.Reset(); // Clear folder selection when tag is selected
 	CurrentSelectedCategory.Reset(); // Clear category selection when tag is selected
+	CurrentSelectedTexture.Reset();
 	UpdateMaterialGridFromTag();
 }
 
@@ -457,6 +498,16 @@ void SMaterialVaultWidget::OnMetadataChanged(TSharedPtr<FMaterialVaultMaterialIt
 	}
 }
 
+void SMaterialVaultWidget::OnShowTextureUsers(TSoftObjectPtr<UTexture2D> Texture)
+{
+	// Like a tag, the texture replaces the folder or category selection
+	CurrentSelectedTexture = Texture.ToSoftObjectPath();
+	CurrentSelectedFolder.Reset();
+	CurrentSelectedCategory.Reset();
+	CurrentSelectedTag.Reset();
+	UpdateMaterialGridFromTexture();
+}
+
 void SMaterialVaultWidget::OnSettingsChanged(const FMaterialVaultSettings& NewSettings)
 {
 	CurrentSettings = NewSettings;
@@ -464,29 +515,46 @@ void SMaterialVaultWidget::OnSettingsChanged(const FMaterialVaultSettings& NewSe
 
 void SMaterialVaultWidget::OnRefreshRequested()
 {
-	UpdateMaterialGrid();
+	// A rebuilt catalog replaces the folder nodes, so re-resolve the selection by path
+	if (CurrentSelectedFolder.IsValid() && MaterialVaultManager)
+	{
+		TSharedPtr<FMaterialVaultFolderNode> RefreshedFolder = MaterialVaultManager->FindFolder(CurrentSelectedFolder->FolderPath);
+		if (RefreshedFolder.IsValid())
+		{
+			CurrentSelectedFolder = RefreshedFolder;
+		}
+	}
+	
+	UpdateMaterialGrid(true);
 }
 
-void SMaterialVaultWidget::UpdateMaterialGrid()
+void SMaterialVaultWidget::UpdateMaterialGrid(bool bForceRefresh)
 {
-	if (MaterialGridWidget.IsValid())
+	// Tag and texture lists are queried again, so refreshes and sort changes keep them in view
+	if (!CurrentSelectedTexture.IsNull())
+	{
+		UpdateMaterialGridFromTexture();
+	}
+	else if (!CurrentSelectedTag.IsEmpty())
+	{
+		UpdateMaterialGridFromTag();
+	}
+	else if (MaterialGridWidget.IsValid())
 	{
 		if (bShowFolders && CurrentSelectedFolder.IsValid())
 		{
 			FString FolderPath = CurrentSelectedFolder->FolderPath;
-			MaterialGridWidget->SetFolder(FolderPath);
+			MaterialGridWidget->SetFolder(FolderPath, bForceRefresh);
 			MaterialGridWidget->SetFilterText(CurrentSearchText);
 		}
 		else if (!bShowFolders && CurrentSelectedCategory.IsValid())
 		{
-			// For categories, set materials directly
-			MaterialGridWidget->SetMaterials(CurrentSelectedCategory->Materials);
-			MaterialGridWidget->SetFilterText(CurrentSearchText);
+			UpdateMaterialGridFromCategory();
 		}
 		else
 		{
 			// Clear selection
-			MaterialGridWidget->SetFolder(FString());
+			MaterialGridWidget->SetFolder(FString(), bForceRefresh);
 			MaterialGridWidget->SetFilterText(CurrentSearchText);
 		}
 	}
@@ -496,7 +564,13 @@ void SMaterialVaultWidget::UpdateMaterialGridFromCategory()
 {
 	if (MaterialGridWidget.IsValid() && CurrentSelectedCategory.IsValid())
 	{
-		MaterialGridWidget->SetMaterials(CurrentSelectedCategory->Materials);
+		// Categories hold their materials unsorted, order a copy by the current sort mode
+		TArray<TSharedPtr<FMaterialVaultMaterialItem>> CategoryMaterials = CurrentSelectedCategory->Materials;
+		if (MaterialVaultManager)
+		{
+			MaterialVaultManager->SortMaterials(CategoryMaterials);
+		}
+		MaterialGridWidget->SetMaterials(CategoryMaterials);
 		MaterialGridWidget->SetFilterText(CurrentSearchText);
 	}
 }
@@ -512,6 +586,17 @@ void SMaterialVaultWidget::UpdateMaterialGridFromTag()
 	}
 }
 
+void SMaterialVaultWidget::UpdateMaterialGridFromTexture()
+{
+	if (MaterialGridWidget.IsValid() && !CurrentSelectedTexture.IsNull() && MaterialVaultManager)
+	{
+		// Looked up in the reverse dependency index, no scan over the catalog
+		TArray<TSharedPtr<FMaterialVaultMaterialItem>> TextureUsers = MaterialVaultManager->GetMaterialsUsingTexture(CurrentSelectedTexture);
+		MaterialGridWidget->SetMaterials(TextureUsers);
+		MaterialGridWidget->SetFilterText(CurrentSearchText);
+	}
+}
+
 void SMaterialVaultWidget::UpdateMetadataPanel()
 {
 	if (MetadataWidget.IsValid())
@@ -532,6 +617,7 @@ void SMaterialVaultWidget::ApplySettings()
 	{
 		MaterialGridWidget->SetViewMode(CurrentSettings.ViewMode);
 		MaterialGridWidget->SetThumbnailSize(CurrentSettings.ThumbnailSize);
+		MaterialGridWidget->SetSearchMode(CurrentSettings.SearchMode);
 	}
 }
 
@@ -549,6 +635,8 @@ FReply SMaterialVaultWidget::OnFoldersTabClicked()
 {
 	bShowFolders = true;
 	CurrentSelectedCategory.Reset();
+	CurrentSelectedTag.Reset();
+	CurrentSelectedTexture.Reset();
 	
 	// Update button styles
 	if (FoldersTabButton.IsValid())
@@ -568,6 +656,8 @@ FReply SMaterialVaultWidget::OnCategoriesTabClicked()
 {
 	bShowFolders = false;
 	CurrentSelectedFolder.Reset();
+	CurrentSelectedTag.Reset();
+	CurrentSelectedTexture.Reset();
 	
 	// Update button styles
 	if (FoldersTabButton.IsValid())
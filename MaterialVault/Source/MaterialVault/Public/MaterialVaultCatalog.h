@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "AssetRegistry/AssetData.h"
+#include "MaterialVaultTypes.h"
+#include "MaterialVaultSearchIndex.h"
+
+/**
+ * Material database: the folder tree plus lookup maps over folders and materials.
+ * A refresh builds a new catalog off the game thread and the manager swaps it in as a whole.
+ */
+class MATERIALVAULT_API FMaterialVaultCatalog
+{
+public:
+	FMaterialVaultCatalog(const FString& InRootFolder);
+	
+	// Folder structure
+	void ResetFolderStructure();
+	void AddMaterialToFolder(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem, bool bKeepSorted = true);
+	void RemoveMaterialFromFolder(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem, const FString& FolderPath);
+	TSharedPtr<FMaterialVaultFolderNode> FindFolder(const FString& FolderPath) const;
+	
+	// Per-folder sort orders, filed under each item's current SortKeys; bulk adds skip sorting and call SortAllFolders once at the end
+	void SortAllFolders();
+	static FMaterialVaultSortKeys MakeSortKeys(const FMaterialVaultMaterialItem& MaterialItem);
+	static bool CompareMaterials(const FMaterialVaultMaterialItem& A, const FMaterialVaultMaterialItem& B, EMaterialVaultSortMode SortMode);
+	
+	// Re-file an item after its sizes or package hash changed outside IndexMaterial
+	void RefreshSortKeys(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	
+	// Keep the tag and search indices in step with an item's current name, path and metadata
+	void IndexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	void UnindexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	
+	// Tag index
+	void IndexMaterialTags(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	void UnindexMaterialTags(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* FindMaterialsWithTag(const FString& Tag) const;
+	int32 GetTagMaterialCount(const FString& Tag) const;
+	
+	// Texture reverse index, filed under each item's resolved TextureDependencies
+	void IndexMaterialTextures(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	void UnindexMaterialTextures(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	const TSet<TSharedPtr<FMaterialVaultMaterialItem>>* FindMaterialsUsingTexture(const FSoftObjectPath& TexturePath) const;
+	int32 GetTextureUserCount(const FSoftObjectPath& TexturePath) const;
+	
+	// Organize package paths into Engine/Content/Plugins structure like Content Browser
+	static FString OrganizePackagePath(const FString& PackagePath);
+	
+	// Data
+	FString RootFolder;
+	TSharedPtr<FMaterialVaultFolderNode> RootFolderNode;
+	TMap<FString, TSharedPtr<FMaterialVaultFolderNode>> FolderMap;
+	TMap<FString, TSharedPtr<FMaterialVaultMaterialItem>> MaterialMap;
+	
+	// Materials per tag, and the tags each item is currently indexed under
+	TMap<FString, TSet<TSharedPtr<FMaterialVaultMaterialItem>>> TagIndex;
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, TArray<FString>> IndexedTags;
+	
+	// Materials per texture, and the textures each item is currently indexed under
+	TMap<FSoftObjectPath, TSet<TSharedPtr<FMaterialVaultMaterialItem>>> TextureUsers;
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, TArray<FSoftObjectPath>> IndexedTextures;
+	
+	// Full-text search over names, paths and metadata
+	FMaterialVaultSearchIndex SearchIndex;
+
+private:
+	static void InsertSorted(FMaterialVaultFolderNode& FolderNode, const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	static void RemoveSorted(FMaterialVaultFolderNode& FolderNode, const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	void UpdateSortKeys(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	
+	void PruneEmptyFolders(TSharedPtr<FMaterialVaultFolderNode> FolderNode);
+	TSharedPtr<FMaterialVaultFolderNode> CreateFolderNode(const FString& FolderPath) const;
+	TSharedPtr<FMaterialVaultFolderNode> GetOrCreateFolderNode(const FString& FolderPath);
+};
+
+/**
+ * Package state recorded in the catalog snapshot, reused by a restored build instead of querying the registry
+ */
+struct FMaterialVaultPackageInfo
+{
+	FIoHash SavedHash;
+	int64 DiskSize = 0;
+	int64 ResourceSize = 0;
+	
+	// Texture dependencies, only meaningful when bDependenciesResolved is set
+	TArray<FSoftObjectPath> TextureDependencies;
+	bool bDependenciesResolved = false;
+};
+
+/**
+ * State shared between a background catalog build and the game thread
+ */
+struct FMaterialVaultCatalogBuild
+{
+	// Catalog being built, published once the build completes
+	TSharedPtr<FMaterialVaultCatalog> Catalog;
+	
+	// Registry snapshot taken on the game thread when the build started
+	TArray<FAssetData> MaterialAssets;
+	
+	// Metadata store the workers read item metadata from
+	TSharedPtr<class FMaterialVaultMetadataStore> MetadataStore;
+	
+	// Package state known up front; anything missing is looked up in the asset registry
+	TMap<FName, FMaterialVaultPackageInfo> KnownPackages;
+	
+	// Texture classes dependency walks keep, gathered on the game thread
+	TSet<FTopLevelAssetPath> TextureClassPaths;
+	
+	// Restored from a snapshot rather than built from a registry query
+	bool bRestoredFromSnapshot = false;
+	
+	// Number of assets processed so far, for progress reporting
+	FThreadSafeCounter ProcessedCount;
+};
+
+/**
+ * Registry check of a catalog restored from the snapshot, compared off the game thread once discovery finishes
+ */
+struct FMaterialVaultCatalogReconcile
+{
+	// Registry snapshot and the package hash each catalog item was built from, taken on the game thread
+	TArray<FAssetData> MaterialAssets;
+	TMap<FSoftObjectPath, FIoHash> CatalogHashes;
+	
+	// Assets that are new or whose package changed, and catalog items no longer in the registry
+	TArray<FAssetData> ChangedAssets;
+	TArray<FString> RemovedPaths;
+};
@@ -8,8 +8,17 @@
 #include "Materials/MaterialInterface.h"
 #include "MaterialVaultTypes.h"
 #include "EditorSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
 #include "MaterialVaultManager.generated.h"
 
+class FMaterialVaultCatalog;
+struct FMaterialVaultCatalogBuild;
+struct FMaterialVaultCatalogReconcile;
+struct FMaterialVaultPackageInfo;
+struct FMaterialVaultThumbnailCacheStats;
+class SNotificationItem;
+
 UCLASS()
 class MATERIALVAULT_API UMaterialVaultManager : public UEditorSubsystem
 {
@@ -28,7 +37,7 @@ public:
 	void LoadMaterialsFromFolder(const FString& FolderPath);
 	
 	// Folder operations
-	TSharedPtr<FMaterialVaultFolderNode> GetRootFolder() const { return RootFolderNode; }
+	TSharedPtr<FMaterialVaultFolderNode> GetRootFolder() const;
 	TSharedPtr<FMaterialVaultFolderNode> FindFolder(const FString& FolderPath) const;
 	TArray<TSharedPtr<FMaterialVaultFolderNode>> GetChildFolders(const FString& FolderPath) const;
 	
@@ -36,9 +45,15 @@ public:
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> GetMaterialsInFolder(const FString& FolderPath) const;
 	TSharedPtr<FMaterialVaultMaterialItem> GetMaterialByPath(const FString& AssetPath) const;
 	void LoadMaterialThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
-	void LoadMaterialDependencies(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
+	void RequestMaterialDependencies(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
 	void ApplyMaterialToSelection(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
 	
+	// Thumbnails for on-screen and prefetched tiles; the delegate runs on the game thread, immediately if the thumbnail is cached
+	int32 RequestMaterialThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bOnScreen);
+	int32 RequestAssetThumbnail(const FAssetData& AssetData, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bOnScreen);
+	void CancelMaterialThumbnail(int32 RequestId);
+	FMaterialVaultThumbnailCacheStats GetThumbnailStats() const;
+	
 	// Metadata operations
 	void SaveMaterialMetadata(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
 	void LoadMaterialMetadata(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem);
@@ -49,7 +64,20 @@ public:
 	
 	// Search and filtering
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> SearchMaterials(const FString& SearchTerm) const;
+	void GetSearchTexts(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials, TArray<FString>& OutSearchTexts) const;
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> FilterMaterialsByTag(const FString& Tag) const;
+	int32 GetMaterialCountForTag(const FString& Tag) const;
+	TArray<FString> GetAllTags() const;
+	
+	// Order a list the catalog doesn't keep sorted, such as a category, by the current sort mode
+	void SortMaterials(TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials) const;
+	
+	// Texture usage, answered from the reverse dependency index
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> GetMaterialsUsingTexture(const FSoftObjectPath& TexturePath) const;
+	int32 GetTextureUserCount(const FSoftObjectPath& TexturePath) const;
+	
+	// Texture details from registry tags, or from one async load when the tags are missing; false until known
+	bool GetTextureInfo(const FSoftObjectPath& TexturePath, FMaterialVaultTextureInfo& OutInfo);
 	
 	// Delegates
 	FOnMaterialVaultFolderSelected OnFolderSelected;
@@ -57,6 +85,7 @@ public:
 	FOnMaterialVaultMaterialDoubleClicked OnMaterialDoubleClicked;
 	FOnMaterialVaultSettingsChanged OnSettingsChanged;
 	FOnMaterialVaultRefreshRequested OnRefreshRequested;
+	FOnMaterialVaultDependenciesResolved OnMaterialDependenciesResolved;
 
 private:
 	// Asset registry callbacks
@@ -64,20 +93,58 @@ private:
 	void OnAssetRemoved(const FAssetData& AssetData);
 	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
 	void OnAssetUpdated(const FAssetData& AssetData);
+	void OnFilesLoaded();
+	
+	// Batched asset event ingestion
+	bool OnTick(float DeltaTime);
+	void FlushPendingAssetEvents();
+	
+	// Background catalog build
+	void GatherMaterialAssets(TArray<FAssetData>& OutMaterialAssets) const;
+	void StartCatalogBuild(TSharedPtr<FMaterialVaultCatalogBuild> Build);
+	static void BuildCatalog(FMaterialVaultCatalogBuild& Build);
+	void PublishCatalog(TSharedPtr<FMaterialVaultCatalogBuild> Build);
+	void UpdateCatalogBuildNotification();
+	void FinishCatalogBuildNotification(bool bSucceeded);
+	
+	// Catalog snapshot
+	bool RestoreCatalogSnapshot();
+	void SaveCatalogSnapshot(bool bAsync);
+	void ReconcileCatalogWithRegistry();
+	static void CompareCatalogWithRegistry(FMaterialVaultCatalogReconcile& Reconcile);
+	void OnCatalogReconciled(TSharedPtr<FMaterialVaultCatalogReconcile> Reconcile);
+	void MarkSnapshotDirty();
+	static FIoHash GetPackageSavedHash(FName PackageName);
+	static void GetPackageSizes(FName PackageName, int64& OutDiskSize, int64& OutResourceSize);
+	
+	// Texture dependencies, gathered from the registry off the game thread
+	const TSet<FTopLevelAssetPath>& GetTextureClassPaths();
+	static void GatherTextureDependencies(FName PackageName, const TSet<FTopLevelAssetPath>& TextureClassPaths, TArray<FSoftObjectPath>& OutTextures);
+	void OnMaterialDependenciesGathered(const FString& ObjectPath, const FMaterialVaultPackageInfo& PackageInfo);
+	
+	// Texture details
+	static bool ReadTextureInfoFromTags(const FAssetData& TextureAsset, FMaterialVaultTextureInfo& OutInfo);
+	void OnTexturePackageLoaded(const FSoftObjectPath& TexturePath, int64 DiskSize);
 	
 	// Internal helpers
-	void ProcessMaterialAsset(const FAssetData& AssetData);
-	void RemoveMaterialAsset(const FAssetData& AssetData);
-	TSharedPtr<FMaterialVaultFolderNode> CreateFolderNode(const FString& FolderPath);
-	TSharedPtr<FMaterialVaultFolderNode> GetOrCreateFolderNode(const FString& FolderPath);
-	void SortMaterials(TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials) const;
-	FString GetMetadataFilePath(const FAssetData& AssetData) const;
-	FString OrganizePackagePath(const FString& PackagePath) const;
+	bool IsMaterialAsset(const FAssetData& AssetData) const;
+	TSharedPtr<FMaterialVaultMaterialItem> ProcessMaterialAsset(const FAssetData& AssetData);
+	TSharedPtr<FMaterialVaultMaterialItem> RemoveMaterialAsset(const FString& ObjectPath);
+	void ReindexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	
+	// Current catalog, replaced as a whole when a background build completes
+	TSharedPtr<FMaterialVaultCatalog> Catalog;
 	
-	// Data members
-	TSharedPtr<FMaterialVaultFolderNode> RootFolderNode;
-	TMap<FString, TSharedPtr<FMaterialVaultFolderNode>> FolderMap;
-	TMap<FString, TSharedPtr<FMaterialVaultMaterialItem>> MaterialMap;
+	// Build in flight, if any; results from any other build are discarded
+	TSharedPtr<FMaterialVaultCatalogBuild> ActiveCatalogBuild;
+	TWeakPtr<SNotificationItem> CatalogBuildNotification;
+	
+	// Snapshot state: a restored catalog is validated once registry discovery finishes, asset events wait while that runs
+	bool bCatalogNeedsValidation = false;
+	TSharedPtr<FMaterialVaultCatalogReconcile> ActiveCatalogReconcile;
+	bool bSnapshotDirty = false;
+	double LastCatalogChangeTime = 0.0;
+	TFuture<void> SnapshotWriteTask;
 	
 	FMaterialVaultSettings Settings;
 	
@@ -87,8 +154,23 @@ private:
 	// Thumbnail manager
 	TSharedPtr<class FMaterialVaultThumbnailManager> ThumbnailManager;
 	
-	// Metadata cache
-	TMap<FString, FMaterialVaultMetadata> MetadataCache;
+	// Metadata for all materials, persisted in a single log file
+	TSharedPtr<class FMaterialVaultMetadataStore> MetadataStore;
+	TSet<FString> MetadataSavedDuringBuild;
+	
+	// Asset registry events waiting for the next flush, keyed by object path
+	TMap<FString, FAssetData> PendingAddedAssets;
+	TSet<FString> PendingRemovedAssets;
+	FTSTicker::FDelegateHandle TickerHandle;
+	
+	// Dependency requests in flight by object path, those whose package changed since they started, and the texture classes they filter on
+	TSet<FString> PendingDependencyRequests;
+	TSet<FString> SupersededDependencyRequests;
+	TSet<FTopLevelAssetPath> TextureClassPaths;
+	
+	// Texture details already read, and textures being loaded because their registry tags were missing
+	TMap<FSoftObjectPath, FMaterialVaultTextureInfo> TextureInfoCache;
+	TSet<FSoftObjectPath> PendingTextureInfoLoads;
 	
 	bool bIsInitialized = false;
 }; 
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "MaterialVaultTypes.h"
+#include "MaterialVaultRecordLog.h"
+
+/**
+ * Single-file metadata store for all materials, keyed by object path.
+ * Loaded with one sequential pass over a FMaterialVaultRecordLog; each save appends one record and the log is compacted periodically.
+ */
+class MATERIALVAULT_API FMaterialVaultMetadataStore
+{
+public:
+	FMaterialVaultMetadataStore();
+	
+	// Load the store, importing the legacy per-material JSON files on first use
+	void Initialize();
+	void Shutdown();
+	
+	// Record access, safe to call from any thread
+	bool Find(const FString& ObjectPath, FMaterialVaultMetadata& OutMetadata) const;
+	void Put(const FString& ObjectPath, const FMaterialVaultMetadata& Metadata);
+	
+	// Rewrite the log with only the latest record per material
+	void Compact();
+	
+	int32 Num() const;
+
+private:
+	// Log file
+	bool LoadLog();
+	static void SerializeRecord(FArchive& Ar, FString& ObjectPath, FMaterialVaultMetadata& Metadata);
+	static FString GetStoreFilePath();
+	
+	// One-time import of the old Saved/MaterialVault/Metadata/*.json files
+	int32 MigrateLegacyMetadata();
+	static bool ReadLegacyMetadataFile(const FString& MetadataPath, FMaterialVaultMetadata& OutMetadata);
+	
+	// Latest metadata per object path
+	TMap<FString, FMaterialVaultMetadata> Records;
+	
+	// One record per save, the latest per object path wins on load
+	FMaterialVaultRecordLog Log;
+	
+	// Records are only locked for map access; the log is written under its own lock, always taken before RecordsLock
+	mutable FCriticalSection RecordsLock;
+	FCriticalSection LogLock;
+};
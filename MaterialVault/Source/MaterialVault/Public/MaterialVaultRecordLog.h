@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Append-only file of length-prefixed records behind a magic and version header, shared by the metadata store and the thumbnail cache.
+ * Owners keep their own index of the latest record per key and serialize Append/Rewrite under their own write lock; Read is safe alongside both.
+ */
+class MATERIALVAULT_API FMaterialVaultRecordLog
+{
+public:
+	FMaterialVaultRecordLog(const FString& InFilePath, uint32 InMagic, int32 InVersion);
+	
+	// Visit each record in file order with the reader at the start of its payload; the visitor must leave the reader at the end of the payload.
+	// False if there is no readable log. A record torn by a crash ends the scan and sets bOutTruncated, the owner should rewrite the log.
+	bool Load(TFunctionRef<bool(FArchive& Reader)> ReadRecord, bool& bOutTruncated);
+	
+	// Append one record; OutPayloadOffset receives the file offset its payload starts at
+	bool Append(const TArray<uint8>& Payload, int64* OutPayloadOffset = nullptr);
+	
+	// Write a fresh log from GetPayload and swap it in, skipping records GetPayload declines.
+	// OnSwapped runs before any Read sees the new file, with each record's payload offset or INDEX_NONE if it was skipped.
+	bool Rewrite(int32 NumRecords, TFunctionRef<bool(int32 RecordIndex, TArray<uint8>& OutPayload)> GetPayload, TFunctionRef<void(const TArray<int64>& PayloadOffsets)> OnSwapped);
+	
+	// Read bytes of the current file; Locate runs under the lock Rewrite swaps the file under, so the offset it gives stays valid for the read
+	bool Read(TFunctionRef<bool(int64& OutOffset, int64& OutSize)> Locate, TArray<uint8>& OutData) const;
+	
+	// Compact once superseded records outnumber live ones, small logs are left alone
+	bool NeedsCompaction(int32 NumLiveRecords) const;
+	
+	// Records in the file, including ones superseded by a later write
+	int32 GetNumRecords() const { return NumRecords; }
+	
+	const FString& GetFilePath() const { return FilePath; }
+
+private:
+	FString FilePath;
+	uint32 Magic;
+	int32 Version;
+	
+	int32 NumRecords;
+	
+	// Held shared while a record is read and exclusively while a rewritten file is swapped in
+	mutable FRWLock FileLock;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "MaterialVaultTypes.h"
+
+/**
+ * Trigram index over the searchable text of each material: name, path, tags, category, author and notes.
+ * Candidates come from intersecting sorted posting lists and are then verified against the stored text.
+ */
+class MATERIALVAULT_API FMaterialVaultSearchIndex
+{
+public:
+	// Add or refresh a material, only touching its postings when the searchable text changed
+	void IndexMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	void RemoveMaterial(const TSharedPtr<FMaterialVaultMaterialItem>& MaterialItem);
+	
+	// Case-insensitive substring search across all indexed fields, results are unsorted
+	void Search(const FString& SearchTerm, TArray<TSharedPtr<FMaterialVaultMaterialItem>>& OutResults) const;
+	
+	// Score a lowercase query against lowercase text, 0 when it doesn't match at all
+	static int32 ScoreFuzzyMatch(FStringView Query, FStringView Text);
+	
+	// Search text helpers for callers that filter their own snapshot of materials off the game thread
+	static FString BuildSearchText(const FMaterialVaultMaterialItem& MaterialItem);
+	void GetSearchTexts(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& Materials, TArray<FString>& OutSearchTexts) const;
+	static int32 ScoreSearchText(FStringView Query, FStringView SearchText);
+	
+	// Typo-tolerant ranking over prebuilt search texts, returning indices best first; false if cancelled part way.
+	// The grid ranks its own folder snapshot with this, fuzzy matches need not share a trigram so the postings can't narrow them.
+	static bool RankSearchTexts(const TArray<FString>& SearchTexts, const FString& SearchTerm, int32 MaxResults, TArray<int32>& OutIndices, const FThreadSafeBool* bCancelled = nullptr);
+	
+	int32 Num() const;
+
+private:
+	static int32 GetSubstringEditDistance(FStringView Query, FStringView Text, int32 MaxDistance);
+	static void GatherTrigrams(const FString& Text, TArray<uint64>& OutTrigrams);
+	
+	void AddPostings(const FString& Text, int32 DocumentId);
+	void RemovePostings(const FString& Text, int32 DocumentId);
+	
+	// Indexed materials and their lowercased search text, addressed by document id
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> Documents;
+	TArray<FString> DocumentText;
+	TArray<int32> FreeDocumentIds;
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, int32> DocumentIds;
+	
+	// Sorted document ids per trigram
+	TMap<uint64, TArray<int32>> Postings;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialVaultTypes.h"
+
+class FMaterialVaultCatalog;
+struct FMaterialVaultCatalogBuild;
+
+/**
+ * Versioned binary snapshot of the material catalog, stored under Saved/MaterialVault.
+ * Restores the vault on launch without waiting for the asset registry.
+ */
+class MATERIALVAULT_API FMaterialVaultSnapshot
+{
+public:
+	// Serialize the catalog entries and the package hashes they were built from
+	static void Write(const FMaterialVaultCatalog& Catalog, TArray<uint8>& OutData);
+	
+	// Fill a catalog build from snapshot data, fails on corrupt data or a different version
+	static bool Read(const TArray<uint8>& Data, FMaterialVaultCatalogBuild& OutBuild);
+	
+	static FString GetSnapshotFilePath();
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "Styling/SlateBrush.h"
+
+class UTexture2D;
+struct FMaterialVaultThumbnailImage;
+
+/**
+ * Where a thumbnail lives in the atlas, used to give the space back
+ */
+struct FMaterialVaultAtlasSlot
+{
+	int32 PageIndex = INDEX_NONE;
+	int32 ShelfIndex = INDEX_NONE;
+	int32 X = 0;
+	
+	bool IsValid() const { return PageIndex != INDEX_NONE; }
+};
+
+/**
+ * Packs thumbnails into a few large textures so the grid draws them from shared resources.
+ * Each page is filled with shelves of equally sized slots; freed slots are reused and empty pages are repacked from scratch.
+ * Game thread only.
+ */
+class MATERIALVAULT_API FMaterialVaultThumbnailAtlas : public FGCObject
+{
+public:
+	FMaterialVaultThumbnailAtlas();
+	virtual ~FMaterialVaultThumbnailAtlas();
+	
+	// Copy a thumbnail into the atlas, returns a brush covering its region or null if it does not fit a page
+	TSharedPtr<FSlateBrush> Add(const FMaterialVaultThumbnailImage& Image, FMaterialVaultAtlasSlot& OutSlot);
+	
+	// The slot is reused once nothing outside the atlas holds the brush any more
+	void Release(const FMaterialVaultAtlasSlot& Slot, TSharedPtr<FSlateBrush> Brush);
+	
+	int32 GetNumPages() const { return Pages.Num(); }
+	
+	// FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+
+private:
+	// A row of slots of one size, filled left to right
+	struct FShelf
+	{
+		int32 Y = 0;
+		int32 SlotSize = 0;
+		int32 NextX = 0;
+		TArray<int32> FreeX;
+	};
+	
+	struct FPage
+	{
+		TObjectPtr<UTexture2D> Texture = nullptr;
+		TArray<FShelf> Shelves;
+		int32 NextShelfY = 0;
+		int32 NumSlots = 0;
+	};
+	
+	// A released slot whose brush may still be on screen
+	struct FPendingRelease
+	{
+		FMaterialVaultAtlasSlot Slot;
+		TSharedPtr<FSlateBrush> Brush;
+	};
+	
+	bool Allocate(int32 SlotSize, FMaterialVaultAtlasSlot& OutSlot, int32& OutY);
+	bool AllocateInPage(int32 PageIndex, int32 SlotSize, FMaterialVaultAtlasSlot& OutSlot, int32& OutY);
+	void FreeSlot(const FMaterialVaultAtlasSlot& Slot);
+	void FlushPendingReleases();
+	UTexture2D* CreatePageTexture() const;
+	void UploadSlot(UTexture2D* Texture, int32 SlotX, int32 SlotY, const FMaterialVaultThumbnailImage& Image) const;
+	
+	TArray<FPage> Pages;
+	TArray<FPendingRelease> PendingReleases;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "IO/IoHash.h"
+#include "MaterialVaultRecordLog.h"
+
+struct FMaterialVaultThumbnailImage;
+
+/**
+ * Compressed thumbnails persisted under Saved/MaterialVault/Thumbnails, keyed by object path and package hash.
+ * On first use the pack is scanned for where each thumbnail lives; pixels stay on disk until requested, new thumbnails are appended and the pack is compacted periodically.
+ */
+class MATERIALVAULT_API FMaterialVaultThumbnailDiskCache
+{
+public:
+	FMaterialVaultThumbnailDiskCache();
+	
+	// Rewrites the pack if it holds stale entries
+	void Shutdown();
+	
+	// Thumbnail access, safe to call from any thread; entries saved from an older package are dropped on lookup
+	bool Find(FName ObjectPath, const FIoHash& PackageSavedHash, FMaterialVaultThumbnailImage& OutImage);
+	void Put(FName ObjectPath, const FIoHash& PackageSavedHash, const FMaterialVaultThumbnailImage& Image);
+	
+	// Rewrite the pack with only the current entry per material
+	void Compact();
+	
+	// Forget thumbnails of assets that no longer exist, the pack drops them when it is next rewritten
+	void Prune(TFunctionRef<bool(FName ObjectPath)> IsLive);
+	
+	int32 Num() const;
+
+private:
+	// Where one thumbnail's compressed pixels are in the pack, and what they decompress to
+	struct FRecord
+	{
+		FIoHash PackageSavedHash;
+		int32 Width = 0;
+		int32 Height = 0;
+		int32 UncompressedSize = 0;
+		int32 CompressedSize = 0;
+		int64 PixelsOffset = 0;
+	};
+	
+	// Pack file
+	void EnsureLoaded();
+	bool LoadPack(TMap<FName, FRecord>& OutRecords, bool& bOutTruncated);
+	static void SerializeRecordHeader(FArchive& Ar, FString& ObjectPath, FRecord& Record);
+	static int64 MakeRecordPayload(const FString& ObjectPath, const FRecord& Record, const TArray<uint8>& CompressedPixels, TArray<uint8>& OutPayload);
+	static FString GetPackFilePath();
+	
+	// Latest thumbnail per object path
+	TMap<FName, FRecord> Records;
+	
+	// Pack file, holding superseded and stale records until it is compacted
+	FMaterialVaultRecordLog Log;
+	
+	FThreadSafeBool bLoaded;
+	
+	// Records are only locked for map access; the pack is written under its own lock, always taken before RecordsLock.
+	// A lookup holds the log's read lock while it takes RecordsLock, so nothing compacts while holding RecordsLock.
+	mutable FCriticalSection RecordsLock;
+	FCriticalSection PackLock;
+};
@@ -6,78 +6,176 @@
 #include "Engine/Texture2D.h"
 #include "Slate/SlateGameResources.h"
 #include "Brushes/SlateDynamicImageBrush.h"
+#include "HAL/ThreadSafeBool.h"
 #include "MaterialVaultTypes.h"
+#include "MaterialVaultThumbnailAtlas.h"
 
 /**
- * Manages thumbnail generation and caching for materials
+ * Thumbnail pixels read from a package, BGRA8
  */
-class MATERIALVAULT_API FMaterialVaultThumbnailManager
+struct FMaterialVaultThumbnailImage
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<uint8> Pixels;
+};
+
+/**
+ * Thumbnail cache counters, reset with ResetCacheStats
+ */
+struct FMaterialVaultThumbnailCacheStats
+{
+	int64 Hits = 0;
+	int64 Misses = 0;
+	int64 Evictions = 0;
+	int64 JoinedRequests = 0;
+	int64 BytesUsed = 0;
+	int64 ByteBudget = 0;
+	int32 NumEntries = 0;
+	int32 NumAtlasPages = 0;
+	int32 NumPendingRequests = 0;
+};
+
+/**
+ * Manages thumbnail extraction and caching for materials and their textures, the one thumbnail source for every vault view.
+ * Thumbnails come from memory, then the disk cache, then the packages, read on worker threads without loading the materials; the rest is game thread only.
+ */
+class MATERIALVAULT_API FMaterialVaultThumbnailManager : public TSharedFromThis<FMaterialVaultThumbnailManager>
 {
 public:
 	FMaterialVaultThumbnailManager();
 	~FMaterialVaultThumbnailManager();
-
+	
 	// Initialize/cleanup
 	void Initialize();
 	void Shutdown();
-
+	
 	// Thumbnail operations
 	TSharedPtr<FSlateBrush> GetMaterialThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize = 128);
-	void RequestThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize = 128);
+	
+	// Requests for the same material share one load whatever their size; returns an id for CancelThumbnailRequest, or INDEX_NONE if nothing is pending for the caller.
+	// High priority requests are for thumbnails on screen and are extracted before any other waiting request.
+	int32 RequestThumbnail(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize = 128, FOnMaterialVaultThumbnailReady OnThumbnailReady = FOnMaterialVaultThumbnailReady(), bool bHighPriority = false);
+	int32 RequestThumbnail(const FAssetData& AssetData, const FIoHash& PackageSavedHash, int32 ThumbnailSize, FOnMaterialVaultThumbnailReady OnThumbnailReady, bool bHighPriority = false);
+	void CancelThumbnailRequest(int32 RequestId);
 	void ClearThumbnailCache();
 	void ClearThumbnailForMaterial(const FString& MaterialPath);
 	
-	// Thumbnail generation
-	UTexture2D* GenerateMaterialThumbnail(UMaterialInterface* Material, int32 ThumbnailSize = 128);
-	TSharedPtr<FSlateDynamicImageBrush> CreateBrushFromTexture(UTexture2D* Texture, int32 ThumbnailSize = 128);
+	// Drop thumbnails saved on disk for assets that no longer exist
+	void PruneDiskCache(TFunctionRef<bool(FName ObjectPath)> IsLive);
 	
-	// Async thumbnail loading
-	void LoadThumbnailAsync(TSharedPtr<FMaterialVaultMaterialItem> MaterialItem, int32 ThumbnailSize = 128);
+	// Thumbnail extraction and downsampling, safe on any thread
+	static bool ExtractPackageThumbnail(const FString& PackageFileName, FName ObjectFullName, FMaterialVaultThumbnailImage& OutImage);
+	static void DownsampleThumbnail(const FMaterialVaultThumbnailImage& Source, FMaterialVaultThumbnailImage& OutImage);
+	static void BuildThumbnailMips(FMaterialVaultThumbnailImage&& Source, TArray<FMaterialVaultThumbnailImage>& OutMips);
+	
+	// Brush creation, game thread only
+	TSharedPtr<FSlateDynamicImageBrush> CreateBrushFromTexture(UTexture2D* Texture, int32 ThumbnailSize = 128);
+	TSharedPtr<FSlateDynamicImageBrush> CreateBrushFromImage(const FMaterialVaultThumbnailImage& Image);
 	
 	// Settings
 	void SetThumbnailSize(int32 NewSize);
 	int32 GetThumbnailSize() const { return DefaultThumbnailSize; }
 	
-	// Cache management
-	void SetMaxCacheSize(int32 MaxSize) { MaxCacheSize = MaxSize; }
+	// Cache management, bounded by the bytes of decoded thumbnail pixels
+	void SetCacheByteBudget(int64 NewByteBudget);
+	int64 GetCacheByteBudget() const { return CacheByteBudget; }
 	int32 GetCacheSize() const { return ThumbnailCache.Num(); }
+	FMaterialVaultThumbnailCacheStats GetCacheStats() const;
+	void ResetCacheStats();
 	void TrimCache();
 
 private:
-	// Thumbnail cache
+	// One thumbnail per material at its saved resolution plus halved levels, linked into the recency list from most to least recently used
 	struct FThumbnailCacheEntry
 	{
-		TSharedPtr<FSlateDynamicImageBrush> Brush;
-		UTexture2D* Texture;
-		int32 ThumbnailSize;
-		FDateTime LastAccessTime;
-		
-		FThumbnailCacheEntry()
-			: Brush(nullptr)
-			, Texture(nullptr)
-			, ThumbnailSize(128)
-			, LastAccessTime(FDateTime::Now())
-		{
-		}
+		FName Key;
+		TArray<TSharedPtr<FSlateBrush>> MipBrushes;
+		TArray<FMaterialVaultAtlasSlot> MipSlots;
+		int64 SizeBytes = 0;
+		FThumbnailCacheEntry* LruPrev = nullptr;
+		FThumbnailCacheEntry* LruNext = nullptr;
 	};
 	
-	TMap<FString, FThumbnailCacheEntry> ThumbnailCache;
+	// Entries are heap allocated so the list links stay valid as the map grows
+	TMap<FName, TUniquePtr<FThumbnailCacheEntry>> ThumbnailCache;
+	FThumbnailCacheEntry* LruHead;
+	FThumbnailCacheEntry* LruTail;
+	int64 CacheBytesUsed;
+	
+	// Cache lookups, touching the entry on a hit
+	FThumbnailCacheEntry* FindCacheEntry(FName Key);
+	void AddCacheEntry(FName Key, const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, const TArray<FMaterialVaultAtlasSlot>& MipSlots, int64 SizeBytes);
+	void RemoveCacheEntry(FName Key);
+	void ReleaseAtlasSlots(FThumbnailCacheEntry& Entry);
+	void LinkAtHead(FThumbnailCacheEntry* Entry);
+	void Unlink(FThumbnailCacheEntry* Entry);
 	
 	// Settings
 	int32 DefaultThumbnailSize;
-	int32 MaxCacheSize;
+	int64 CacheByteBudget;
+	
+	// Cache counters
+	int64 CacheHits;
+	int64 CacheMisses;
+	int64 CacheEvictions;
+	int64 JoinedRequests;
+	
+	// Caller waiting on a request, served from the level matching its size
+	struct FThumbnailListener
+	{
+		int32 RequestId = INDEX_NONE;
+		int32 ThumbnailSize = 0;
+		FOnMaterialVaultThumbnailReady OnThumbnailReady;
+	};
 	
-	// Async loading
-	TMap<FString, TSharedPtr<FMaterialVaultMaterialItem>> PendingThumbnails;
+	// One request per material, either queued or being extracted
+	struct FThumbnailRequest
+	{
+		FString PackageFileName;
+		FName ObjectFullName;
+		FIoHash PackageSavedHash;
+		TArray<FThumbnailListener> Listeners;
+		TSharedPtr<FThreadSafeBool> CancelFlag;
+		bool bHighPriority = false;
+		bool bLoading = false;
+	};
+	
+	// Async extraction, keyed like the cache by object path
+	TMap<FName, FThumbnailRequest> Requests;
+	TArray<FName> QueuedRequestKeys;
+	TArray<FName> QueuedPriorityKeys;
+	TMap<int32, FName> RequestKeysById;
+	int32 NextRequestId;
+	int32 NumActiveLoads;
+	int32 MaxActiveLoads;
+	int32 MaxQueuedRequests;
+	
+	void QueueRequest(const FAssetData& AssetData, const FIoHash& PackageSavedHash, FName CacheKey, bool bHighPriority);
+	void PumpRequests();
+	void StartLoad(FName RequestKey);
+	void OnThumbnailExtracted(FName RequestKey, TSharedPtr<TArray<FMaterialVaultThumbnailImage>> Mips);
+	void OnCancelledLoadFinished();
+	void CancelRequest(FName RequestKey);
+	void FinishRequest(FName RequestKey, const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, bool bDropped);
 	
 	// Helper functions
-	FString GetCacheKey(const FString& MaterialPath, int32 ThumbnailSize) const;
-	void OnThumbnailGenerated(const FString& MaterialPath, UTexture2D* Thumbnail, int32 ThumbnailSize);
+	static FName MakeCacheKey(const FAssetData& AssetData);
+	static TSharedPtr<FSlateBrush> SelectMipBrush(const TArray<TSharedPtr<FSlateBrush>>& MipBrushes, int32 ThumbnailSize);
 	UTexture2D* GetDefaultMaterialThumbnail() const;
 	
+	// Extracted thumbnails persisted across sessions, checked before the package
+	TSharedPtr<class FMaterialVaultThumbnailDiskCache> DiskCache;
+	
+	// Texture pages the cached thumbnails are packed into
+	TSharedPtr<FMaterialVaultThumbnailAtlas> Atlas;
+	
 	// Default textures
 	UTexture2D* DefaultMaterialTexture;
 	UTexture2D* ErrorTexture;
 	
+	// Dynamic image resources need unique names
+	int32 NextBrushId;
+	
 	bool bIsInitialized = false;
-}; 
\ No newline at end of file
+};
\ No newline at end of file
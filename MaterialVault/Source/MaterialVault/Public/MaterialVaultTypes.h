@@ -9,6 +9,7 @@
 #include "Containers/Array.h"
 #include "Containers/Map.h"
 #include "UObject/SoftObjectPath.h"
+#include "IO/IoHash.h"
 #include "MaterialVaultTypes.generated.h"
 
 USTRUCT()
@@ -48,6 +49,63 @@ struct MATERIALVAULT_API FMaterialVaultMetadata
 	}
 };
 
+UENUM()
+enum class EMaterialVaultSortMode : uint8
+{
+	Name,
+	DateModified,
+	Size,
+	Type,
+	Count UMETA(Hidden)
+};
+
+/**
+ * Keys a material is ordered by, precomputed so sorting never converts names or paths
+ */
+struct FMaterialVaultSortKeys
+{
+	// Lowercased display name
+	FString Name;
+
+	// Metadata modification time
+	FDateTime Modified;
+
+	// Rank of the asset class, in class path order
+	uint8 Type = 0;
+
+	// Estimated resource footprint
+	int64 Size = 0;
+
+	bool operator==(const FMaterialVaultSortKeys& Other) const
+	{
+		return Type == Other.Type && Size == Other.Size && Modified == Other.Modified && Name.Equals(Other.Name, ESearchCase::CaseSensitive);
+	}
+
+	bool operator!=(const FMaterialVaultSortKeys& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+/**
+ * Texture details shown in the dependency list, read without a blocking load
+ */
+struct FMaterialVaultTextureInfo
+{
+	// Source dimensions
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// Pixel format name, e.g. PF_DXT5
+	FString Format;
+
+	// Package size on disk
+	int64 DiskSize = 0;
+
+	// Not in the asset registry, e.g. deleted or renamed since the material last referenced it
+	bool bMissing = false;
+};
+
 USTRUCT()
 struct MATERIALVAULT_API FMaterialVaultMaterialItem
 {
@@ -61,35 +119,39 @@ struct MATERIALVAULT_API FMaterialVaultMaterialItem
 	UPROPERTY()
 	TSoftObjectPtr<UMaterialInterface> MaterialPtr;
 
-	// Cached thumbnail
-	TSharedPtr<struct FSlateBrush> ThumbnailBrush;
-
 	// Metadata
 	UPROPERTY()
 	FMaterialVaultMetadata Metadata;
 
-	// Texture dependencies
+	// Texture dependencies, resolved from the asset registry on first request
 	UPROPERTY()
 	TArray<TSoftObjectPtr<UTexture2D>> TextureDependencies;
+	bool bDependenciesResolved = false;
 
 	// Display name
 	FString DisplayName;
 
-	// Whether thumbnail is loaded
-	bool bThumbnailLoaded = false;
+	// Organized folder path this item is filed under in the folder tree
+	FString OrganizedPath;
+
+	// Hash of the package when this item was processed, used to validate the catalog snapshot
+	FIoHash PackageSavedHash;
+
+	// Package size on disk, and the estimated footprint of the package plus everything it hard-references
+	int64 DiskSize = 0;
+	int64 ResourceSize = 0;
+
+	// Sort keys the item is currently filed under in its folder's sorted orders
+	FMaterialVaultSortKeys SortKeys;
 
 	FMaterialVaultMaterialItem()
 		: MaterialPtr(nullptr)
-		, ThumbnailBrush(nullptr)
-		, bThumbnailLoaded(false)
 	{
 	}
 
 	FMaterialVaultMaterialItem(const FAssetData& InAssetData)
 		: AssetData(InAssetData)
 		, MaterialPtr(InAssetData.ToSoftObjectPath())
-		, ThumbnailBrush(nullptr)
-		, bThumbnailLoaded(false)
 	{
 		DisplayName = AssetData.AssetName.ToString();
 		Metadata.MaterialName = DisplayName;
@@ -117,6 +179,9 @@ struct MATERIALVAULT_API FMaterialVaultFolderNode
 	// Materials in this folder
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> Materials;
 
+	// Materials in each EMaterialVaultSortMode order, maintained by the catalog
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> SortedMaterials[(int32)EMaterialVaultSortMode::Count];
+
 	// Whether this folder is expanded in the tree
 	bool bIsExpanded = false;
 
@@ -145,12 +210,10 @@ enum class EMaterialVaultViewMode : uint8
 };
 
 UENUM()
-enum class EMaterialVaultSortMode : uint8
+enum class EMaterialVaultSearchMode : uint8
 {
-	Name,
-	DateModified,
-	Size,
-	Type
+	Substring,
+	Fuzzy
 };
 
 USTRUCT()
@@ -164,9 +227,15 @@ struct MATERIALVAULT_API FMaterialVaultSettings
 	UPROPERTY()
 	EMaterialVaultSortMode SortMode = EMaterialVaultSortMode::Name;
 
+	UPROPERTY()
+	EMaterialVaultSearchMode SearchMode = EMaterialVaultSearchMode::Substring;
+
 	UPROPERTY()
 	float ThumbnailSize = 128.0f;
 
+	UPROPERTY()
+	int32 ThumbnailPrefetchRows = 2;
+	
 	UPROPERTY()
 	bool bShowMetadata = true;
 
@@ -184,8 +253,11 @@ struct MATERIALVAULT_API FMaterialVaultSettings
 };
 
 // Delegate declarations
+// A null brush means the asset has no thumbnail; a dropped request got no answer and can be made again
+DECLARE_DELEGATE_TwoParams(FOnMaterialVaultThumbnailReady, TSharedPtr<struct FSlateBrush>, bool /*bDropped*/);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnMaterialVaultFolderSelected, TSharedPtr<FMaterialVaultFolderNode>);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnMaterialVaultMaterialSelected, TSharedPtr<FMaterialVaultMaterialItem>);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnMaterialVaultMaterialDoubleClicked, TSharedPtr<FMaterialVaultMaterialItem>);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnMaterialVaultSettingsChanged, const FMaterialVaultSettings&);
-DECLARE_MULTICAST_DELEGATE(FOnMaterialVaultRefreshRequested); 
\ No newline at end of file
+DECLARE_MULTICAST_DELEGATE(FOnMaterialVaultRefreshRequested);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMaterialVaultDependenciesResolved, TSharedPtr<FMaterialVaultMaterialItem>); 
\ No newline at end of file
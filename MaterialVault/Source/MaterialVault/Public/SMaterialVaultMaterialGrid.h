@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/SLeafWidget.h"
 #include "Widgets/Views/STileView.h"
 #include "Widgets/Views/SListView.h"
 #include "Widgets/Views/STableViewBase.h"
@@ -11,12 +12,67 @@
 #include "Widgets/Images/SImage.h"
 #include "Widgets/Input/SButton.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
-#include "AssetThumbnail.h"
-#include "ThumbnailRendering/ThumbnailManager.h"
+#include "Fonts/ShapedTextFwd.h"
+#include "HAL/ThreadSafeBool.h"
 #include "MaterialVaultTypes.h"
 
 class UMaterialVaultManager;
 
+/**
+ * Read-only snapshot of the grid's materials and their search text, shared with background filter tasks
+ */
+struct FMaterialVaultGridFilterSource
+{
+	TArray<TSharedPtr<FMaterialVaultMaterialItem>> Materials;
+	TArray<FString> SearchTexts;
+};
+
+/**
+ * Everything a material tile shows, painted by a single leaf widget.
+ * The name is shaped once per display scale and the tooltip is only built when the tile is first hovered.
+ */
+class SMaterialVaultMaterialTileContent : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMaterialVaultMaterialTileContent) {}
+		SLATE_ARGUMENT(TSharedPtr<FMaterialVaultMaterialItem>, MaterialItem)
+		SLATE_ARGUMENT(float, ThumbnailSize)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// SWidget interface
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	virtual TSharedPtr<IToolTip> GetToolTip() override;
+
+	// Thumbnail state; a null brush once resolved shows the material class icon
+	void SetThumbnailBrush(TSharedPtr<FSlateBrush> InThumbnailBrush);
+	void ResetThumbnail();
+	void MarkThumbnailStale();
+	bool IsThumbnailResolved() const { return bThumbnailResolved; }
+	void SetThumbnailSize(float InThumbnailSize);
+
+private:
+	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem;
+	float ThumbnailSize;
+	TSharedPtr<FSlateBrush> ThumbnailBrush;
+	bool bThumbnailResolved;
+	
+	// Label font and the name shaped for the scale it was last painted at
+	FSlateFontInfo LabelFont;
+	float LabelHeight;
+	mutable FShapedGlyphSequencePtr ShapedLabel;
+	mutable FShapedGlyphSequencePtr ShapedEllipsis;
+	mutable float ShapedLabelScale;
+	
+	TSharedPtr<IToolTip> MaterialToolTip;
+
+	// UI helpers
+	void ShapeLabel(float FontScale) const;
+	FText GetMaterialTooltip() const;
+};
+
 /**
  * Tile widget for material items in grid view
  */
@@ -38,6 +94,14 @@ public:
 	virtual void OnDragLeave(const FDragDropEvent& DragDropEvent) override;
 	virtual FReply OnDragDetected(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 
+	// Thumbnail, supplied by the grid's scheduler; a null brush shows the material class icon
+	void SetThumbnailBrush(TSharedPtr<FSlateBrush> InThumbnailBrush);
+	bool IsThumbnailResolved() const;
+	
+	// Resize in place, the stale thumbnail stays up until the grid supplies one of the new resolution
+	void SetThumbnailSize(float InThumbnailSize, bool bThumbnailStale);
+	TSharedPtr<FMaterialVaultMaterialItem> GetMaterialItem() const { return MaterialItem; }
+	
 	// Delegates
 	DECLARE_DELEGATE_OneParam(FOnMaterialClicked, TSharedPtr<FMaterialVaultMaterialItem>);
 	DECLARE_DELEGATE_OneParam(FOnMaterialDoubleClicked, TSharedPtr<FMaterialVaultMaterialItem>);
@@ -49,14 +113,9 @@ public:
 
 private:
 	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem;
-	TSharedPtr<FAssetThumbnail> AssetThumbnail;
+	TSharedPtr<SMaterialVaultMaterialTileContent> TileContent;
 	float ThumbnailSize;
 
-	// UI helpers
-	FText GetMaterialName() const;
-	FText GetMaterialTooltip() const;
-	EVisibility GetLoadingVisibility() const;
-	
 	// Thumbnail helpers
 	void RefreshThumbnail();
 };
@@ -88,7 +147,6 @@ public:
 
 private:
 	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem;
-	TSharedPtr<FAssetThumbnail> AssetThumbnail;
 
 	// UI helpers
 	FText GetMaterialName() const;
@@ -108,7 +166,8 @@ public:
 
 	/** Constructs this widget with InArgs */
 	void Construct(const FArguments& InArgs);
-
+	virtual ~SMaterialVaultMaterialGrid();
+	
 	// Public interface
 	void RefreshGrid();
 	void SetMaterials(const TArray<TSharedPtr<FMaterialVaultMaterialItem>>& InMaterials);
@@ -117,10 +176,11 @@ public:
 	void SetViewMode(EMaterialVaultViewMode InViewMode);
 	void SetThumbnailSize(float InThumbnailSize);
 	void ClearSelection();
-	void SetFolder(const FString& FolderPath);
+	void SetFolder(const FString& FolderPath, bool bForceRefresh = false);
 
 	// Search and filtering
 	void SetFilterText(const FString& FilterText);
+	void SetSearchMode(EMaterialVaultSearchMode InSearchMode);
 	void ApplyFilters();
 
 	// Delegates
@@ -137,32 +197,70 @@ private:
 	TSharedPtr<STileView<TSharedPtr<FMaterialVaultMaterialItem>>> TileView;
 	TSharedPtr<SListView<TSharedPtr<FMaterialVaultMaterialItem>>> ListView;
 	TSharedPtr<SBorder> ViewContainer;
+	TSharedPtr<STextBlock> StatusTextBlock;
 
 	// Data
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> AllMaterials;
 	TArray<TSharedPtr<FMaterialVaultMaterialItem>> FilteredMaterials;
 	TSharedPtr<FMaterialVaultMaterialItem> SelectedMaterial;
+	
+	// Folder AllMaterials was fetched from, unset while showing a category or tag
+	FString CurrentFolderPath;
+	bool bShowingFolder;
+	
+	// Background filter state; results from any generation but the latest are discarded
+	TSharedPtr<const FMaterialVaultGridFilterSource> FilterSource;
+	TArray<int32> FilteredIndices;
+	FString FilteredText;
+	int32 FilterGeneration;
+	TSharedPtr<FThreadSafeBool> FilterCancelFlag;
+	TSharedPtr<FActiveTimerHandle> FilterTimerHandle;
 
 	// Settings
 	EMaterialVaultViewMode ViewMode;
 	float ThumbnailSize;
+	int32 ThumbnailRequestSize;
 	FString CurrentFilterText;
+	EMaterialVaultSearchMode SearchMode;
 
 	// Manager reference
 	UMaterialVaultManager* MaterialVaultManager;
 
-	// Thumbnail management
-	TSharedPtr<FAssetThumbnailPool> ThumbnailPool;
-
+	// Thumbnail scheduling for the tile view: on-screen tiles first, then rows ahead in the scroll direction
+	struct FTileThumbnailRequest
+	{
+		int32 RequestId = INDEX_NONE;
+		bool bOnScreen = false;
+	};
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, TWeakPtr<SMaterialVaultMaterialTile>> LiveTiles;
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, FTileThumbnailRequest> TileThumbnailRequests;
+	TMap<TSharedPtr<FMaterialVaultMaterialItem>, TSharedPtr<FSlateBrush>> PrefetchedThumbnails;
+	double LastScrollOffset;
+	int32 ScrollDirection;
+	TSharedPtr<FActiveTimerHandle> TileThumbnailTimerHandle;
+	
 	// View creation
 	TSharedRef<SWidget> CreateTileView();
+	float GetTileItemWidth() const;
+	float GetTileItemHeight() const;
 	TSharedRef<SWidget> CreateListView();
 	void SwitchToViewMode(EMaterialVaultViewMode NewViewMode);
 
 	// Tile view callbacks
 	TSharedRef<ITableRow> OnGenerateTileWidget(TSharedPtr<FMaterialVaultMaterialItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnTileReleased(const TSharedRef<ITableRow>& TileRow);
 	void OnTileSelectionChanged(TSharedPtr<FMaterialVaultMaterialItem> SelectedItem, ESelectInfo::Type SelectInfo);
 	
+	// Thumbnail scheduling, run each frame only while tiles are generated or scrolled
+	void ScheduleTileThumbnailUpdate();
+	EActiveTimerReturnType OnTileThumbnailTimer(double InCurrentTime, float InDeltaTime);
+	void OnTileViewScrolled(double ScrollOffset);
+	bool UpdateTileThumbnails(float InDeltaTime);
+	void RequestTileThumbnail(TSharedPtr<FMaterialVaultMaterialItem> Item, bool bOnScreen);
+	void OnTileThumbnailReady(TSharedPtr<FSlateBrush> Brush, bool bDropped, TWeakPtr<FMaterialVaultMaterialItem> WeakItem);
+	void CancelTileThumbnails();
+	static int32 GetThumbnailRequestSize(float InThumbnailSize);
+	
 	// List view callbacks
 	TSharedRef<ITableRow> OnGenerateListWidget(TSharedPtr<FMaterialVaultMaterialItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
 	void OnListSelectionChanged(TSharedPtr<FMaterialVaultMaterialItem> SelectedItem, ESelectInfo::Type SelectInfo);
@@ -180,12 +278,18 @@ private:
 	void OnCopyMaterialPath();
 	void OnEditMaterialMetadata();
 
-	// Filtering
+	// Filtering, run on a background task after a short debounce
 	void UpdateFilteredMaterials();
-	bool DoesItemPassFilter(TSharedPtr<FMaterialVaultMaterialItem> Item) const;
+	void ScheduleFilterTask();
+	void StartFilterTask();
+	void CancelFilterTask();
+	EActiveTimerReturnType OnFilterTimer(double InCurrentTime, float InDeltaTime);
+	void OnFilterTaskComplete(int32 Generation, TSharedPtr<const FMaterialVaultGridFilterSource> Source, const FString& FilterText, TArray<int32> Indices);
+	void RequestViewRefresh();
 
 	// Helper functions
 	void UpdateSelection(TSharedPtr<FMaterialVaultMaterialItem> NewSelection);
 	void ScrollToMaterial(TSharedPtr<FMaterialVaultMaterialItem> Material);
 	FText GetStatusText() const;
+	void UpdateStatusText();
 }; 
\ No newline at end of file
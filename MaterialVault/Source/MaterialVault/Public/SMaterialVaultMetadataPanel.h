@@ -13,10 +13,10 @@
 #include "Widgets/Input/SComboBox.h"
 #include "Widgets/Views/SListView.h"
 #include "Widgets/Images/SImage.h"
-#include "AssetThumbnail.h"
 #include "MaterialVaultTypes.h"
 
 class UMaterialVaultManager;
+class SMaterialVaultThumbnail;
 
 /**
  * Wrapper for texture soft object pointer to make it compatible with table rows
@@ -25,8 +25,11 @@ struct FMaterialVaultTextureItem
 {
 	TSoftObjectPtr<UTexture2D> Texture;
 	
+	// Materials in the vault that use this texture
+	int32 UserCount = 0;
+	
 	FMaterialVaultTextureItem() = default;
-	FMaterialVaultTextureItem(TSoftObjectPtr<UTexture2D> InTexture) : Texture(InTexture) {}
+	FMaterialVaultTextureItem(TSoftObjectPtr<UTexture2D> InTexture, int32 InUserCount = 0) : Texture(InTexture), UserCount(InUserCount) {}
 };
 
 /**
@@ -79,6 +82,10 @@ public:
 	// Update the displayed material
 	void SetMaterialItem(TSharedPtr<FMaterialVaultMaterialItem> InMaterialItem);
 
+	// Delegates
+	DECLARE_DELEGATE_OneParam(FOnShowTextureUsers, TSoftObjectPtr<UTexture2D>);
+	FOnShowTextureUsers OnShowTextureUsers;
+
 private:
 	TSharedPtr<FMaterialVaultMaterialItem> MaterialItem;
 	TSharedPtr<SListView<TSharedPtr<FMaterialVaultTextureItem>>> TextureListView;
@@ -90,7 +97,9 @@ private:
 
 	// Operations
 	void RefreshTextureDependencies();
+	void OnDependenciesResolved(TSharedPtr<FMaterialVaultMaterialItem> ResolvedItem);
 	void OnTextureDoubleClicked(TSoftObjectPtr<UTexture2D> Texture);
+	void OnTextureUsersClicked(TSoftObjectPtr<UTexture2D> Texture);
 };
 
 /**
@@ -108,18 +117,23 @@ public:
 	// Delegates
 	DECLARE_DELEGATE_OneParam(FOnTextureDoubleClicked, TSoftObjectPtr<UTexture2D>);
 	FOnTextureDoubleClicked OnTextureDoubleClicked;
+	DECLARE_DELEGATE_OneParam(FOnTextureUsersClicked, TSoftObjectPtr<UTexture2D>);
+	FOnTextureUsersClicked OnTextureUsersClicked;
 
 	// SWidget interface
 	virtual FReply OnMouseButtonDoubleClick(const FGeometry& InMyGeometry, const FPointerEvent& InMouseEvent) override;
 
 private:
 	TSharedPtr<FMaterialVaultTextureItem> TextureItem;
-	TSharedPtr<FAssetThumbnail> AssetThumbnail;
+	UMaterialVaultManager* MaterialVaultManager;
 
 	// UI helpers
 	FText GetTextureName() const;
 	FText GetTextureInfo() const;
 	FText GetTextureTooltip() const;
+	FText GetTextureUsersText() const;
+	EVisibility GetTextureUsersVisibility() const;
+	void OnTextureUsersNavigate();
 };
 
 /**
@@ -143,6 +157,8 @@ public:
 	// Delegates
 	DECLARE_DELEGATE_OneParam(FOnMetadataChanged, TSharedPtr<FMaterialVaultMaterialItem>);
 	FOnMetadataChanged OnMetadataChanged;
+	DECLARE_DELEGATE_OneParam(FOnShowTextureUsers, TSoftObjectPtr<UTexture2D>);
+	FOnShowTextureUsers OnShowTextureUsers;
 
 private:
 	// Current material
@@ -152,16 +168,20 @@ private:
 	UMaterialVaultManager* MaterialVaultManager;
 
 	// UI components
+	TSharedPtr<SBox> NoSelectionBox;
 	TSharedPtr<SScrollBox> ContentScrollBox;
 	TSharedPtr<SEditableTextBox> MaterialNameTextBox;
 	TSharedPtr<STextBlock> LocationTextBlock;
 	TSharedPtr<SEditableTextBox> AuthorTextBox;
 	TSharedPtr<STextBlock> LastModifiedTextBlock;
+	TSharedPtr<STextBlock> SizeTextBlock;
 	TSharedPtr<SEditableTextBox> CategoryTextBox;
 	TSharedPtr<SMultiLineEditableTextBox> NotesTextBox;
 	TSharedPtr<SMaterialVaultTagEditor> TagEditor;
 	TSharedPtr<SMaterialVaultTextureDependencies> TextureDependencies;
+	TSharedPtr<SMaterialVaultThumbnail> PreviewThumbnail;
 	TSharedPtr<SButton> SaveButton;
+	TSharedPtr<STextBlock> SaveButtonText;
 	TSharedPtr<SButton> RevertButton;
 
 	// State tracking
@@ -182,6 +202,8 @@ private:
 	void OnCategoryChanged(const FText& NewText);
 	void OnNotesChanged(const FText& NewText);
 	void OnTagsChanged(const TArray<FString>& NewTags);
+	void OnTextureUsersRequested(TSoftObjectPtr<UTexture2D> Texture);
+	void OnDependenciesResolved(TSharedPtr<FMaterialVaultMaterialItem> ResolvedItem);
 
 	// Button actions
 	FReply OnSaveClicked();
@@ -197,12 +219,13 @@ private:
 	void UpdateUI();
 	void MarkAsChanged();
 	void MarkAsClean();
+	void UpdateSaveState();
 	
 	// Asset operations
 	bool RenameAsset(const FString& NewName);
 	bool IsEnabled() const;
 	FText GetMaterialTypeText() const;
-	FText GetMaterialSizeText() const;
+	static FText GetMaterialSizeText(const TSharedPtr<FMaterialVaultMaterialItem>& SizedItem);
 	EVisibility GetNoSelectionVisibility() const;
 	EVisibility GetContentVisibility() const;
 	EVisibility GetSaveButtonVisibility() const;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "AssetRegistry/AssetData.h"
+#include "MaterialVaultTypes.h"
+
+class UMaterialVaultManager;
+class SImage;
+class SCircularThrobber;
+
+/**
+ * Asset thumbnail served by the vault's thumbnail manager, so every view showing an asset shares one cached copy
+ */
+class MATERIALVAULT_API SMaterialVaultThumbnail : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMaterialVaultThumbnail)
+		: _ThumbnailSize(64)
+		{}
+		SLATE_ARGUMENT(FAssetData, AssetData)
+		SLATE_ARGUMENT(int32, ThumbnailSize)
+	SLATE_END_ARGS()
+	
+	/** Constructs this widget with InArgs */
+	void Construct(const FArguments& InArgs);
+	virtual ~SMaterialVaultThumbnail();
+	
+	// Show another asset, dropping the request for the previous one
+	void SetAssetData(const FAssetData& InAssetData);
+
+private:
+	FAssetData AssetData;
+	int32 ThumbnailSize;
+	
+	// Null once resolved means the package has no thumbnail and the class icon is shown
+	TSharedPtr<FSlateBrush> ThumbnailBrush;
+	bool bThumbnailResolved;
+	int32 RequestId;
+	
+	// Manager reference
+	UMaterialVaultManager* MaterialVaultManager;
+	
+	// UI components
+	TSharedPtr<SImage> ThumbnailImage;
+	TSharedPtr<SCircularThrobber> LoadingThrobber;
+	
+	// Thumbnail requests
+	void RequestThumbnail();
+	void CancelThumbnailRequest();
+	void OnThumbnailReady(TSharedPtr<FSlateBrush> Brush, bool bDropped);
+	EActiveTimerReturnType OnRetryThumbnailRequest(double InCurrentTime, float InDeltaTime);
+	
+	// UI helpers
+	void UpdateThumbnailWidgets();
+	const FSlateBrush* GetThumbnailBrush() const;
+	EVisibility GetLoadingVisibility() const;
+};
@@ -32,9 +32,6 @@ public:
 	/** Constructs this widget with InArgs */
 	void Construct(const FArguments& InArgs);
 
-	// SWidget interface
-	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
-
 	// Refresh the entire interface
 	void RefreshInterface();
 
@@ -62,6 +59,7 @@ private:
 	void OnMaterialDoubleClicked(TSharedPtr<FMaterialVaultMaterialItem> SelectedMaterial);
 	void OnMaterialApplied(TSharedPtr<FMaterialVaultMaterialItem> MaterialToApply);
 	void OnMetadataChanged(TSharedPtr<FMaterialVaultMaterialItem> ChangedMaterial);
+	void OnShowTextureUsers(TSoftObjectPtr<UTexture2D> Texture);
 	void OnSettingsChanged(const FMaterialVaultSettings& NewSettings);
 	void OnRefreshRequested();
 
@@ -72,6 +70,8 @@ private:
 	void OnThumbnailSizeChanged(float NewSize);
 	void OnSearchTextChanged(const FText& SearchText);
 	void OnSortModeChanged(EMaterialVaultSortMode NewSortMode);
+	ECheckBoxState GetFuzzySearchCheckState() const;
+	void OnFuzzySearchCheckStateChanged(ECheckBoxState NewState);
 
 	// Tab event handlers
 	FReply OnFoldersTabClicked();
@@ -85,6 +85,7 @@ private:
 	TSharedPtr<struct FMaterialVaultCategoryItem> CurrentSelectedCategory;
 	TSharedPtr<FMaterialVaultMaterialItem> CurrentSelectedMaterial;
 	FString CurrentSelectedTag; // Currently selected tag for filtering
+	FSoftObjectPath CurrentSelectedTexture; // Texture whose users are listed in the grid
 	FString CurrentSearchText;
 	bool bShowFolders = true;
 
@@ -99,9 +100,10 @@ private:
 	TSharedRef<SWidget> CreateMetadataPanel();
 
 	// Utility functions
-	void UpdateMaterialGrid();
+	void UpdateMaterialGrid(bool bForceRefresh = false);
 	void UpdateMaterialGridFromCategory();
 	void UpdateMaterialGridFromTag(); // Update grid for tag filtering
+	void UpdateMaterialGridFromTexture();
 	void UpdateMetadataPanel();
 	void ApplySettings();
 	void SaveSettings();